@@ -0,0 +1,338 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "utility.h"
+#include "aet_source.h"
+
+// Global variables required to find the actual execution times of the jobs.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+
+// Tasks.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+
+// Model of every task (sorted based on period).
+_Thread_local Aet_source *aet_sources;
+
+// Names of the models in the input file (in the order of their numbers).
+static const char *const aet_model_names[] = {"uniform", "beta", "bimodal", "markov", "trace"};
+static const int aet_model_num_params[] = {2, 2, 4, 5, 0};
+
+
+/*
+ * Pre-condition: The sorted task-set.
+ * Post-condition: Every task follows the default uniform model, unless the input file of the models gives another one.
+ */
+void
+init_aet_sources()
+{
+    aet_sources = (Aet_source *) calloc(num_tasks, sizeof(Aet_source));
+    for (int i = 0; i < num_tasks; i++)
+    {
+        aet_sources[i].model = UNIFORM_AET;
+        aet_sources[i].params[0] = MIN_PERCENT_EXECUTION / 100.0;
+        aet_sources[i].params[1] = 1;
+    }
+
+    if (AET_MODELS_FROM_FILE)
+    {
+        input_aet_sources();
+        print_aet_sources();
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An input file with the number of models followed by the task number, the name of the model and its parameters (one task per line).
+ * Post-condition: The models of the given tasks are initialised, and their traces are memory-mapped.
+ *
+ * The traces are streamed from their mappings, so they are never read into memory as a whole. Tasks that are not in the task-set (such as those on other cores) are skipped.
+ */
+void
+input_aet_sources()
+{
+    Input_file input_aet_file;
+    open_input_file(&input_aet_file, INPUT_AET_FILE_NAME);
+
+    long num_models_input;
+    if (!scan_long(&input_aet_file, &num_models_input) || num_models_input < 0)
+        parse_error(&input_aet_file, input_aet_file.line, "Invalid number of execution time models");
+
+    for (long i = 0; i < num_models_input; i++) // Iterates over all the models.
+    {
+        // Every model is on its own line.
+        skip_whitespace(&input_aet_file);
+        int line = input_aet_file.line;
+
+        long task_num;
+        char model_name[AET_MODEL_NAME_LENGTH];
+        if (!scan_long(&input_aet_file, &task_num) || !scan_word(&input_aet_file, model_name, sizeof(model_name)))
+            parse_error(&input_aet_file, line, "Expected the task number and the name of an execution time model");
+
+        Aet_source source;
+        memset(&source, 0, sizeof(source));
+        source.model = -1;
+        for (int j = 0; j <= TRACE_AET; j++)
+        {
+            if (strcmp(model_name, aet_model_names[j]) == 0)
+                source.model = j;
+        }
+        if (source.model < 0)
+            parse_error(&input_aet_file, line, "Unknown execution time model (has to be uniform, beta, bimodal, markov or trace)");
+
+        for (int j = 0; j < aet_model_num_params[source.model]; j++)
+        {
+            if (!scan_float(&input_aet_file, &source.params[j]) || source.params[j] < 0)
+                parse_error(&input_aet_file, line, "Invalid parameter of an execution time model");
+        }
+
+        if (source.model == TRACE_AET && !scan_word(&input_aet_file, source.trace_file_name, sizeof(source.trace_file_name)))
+            parse_error(&input_aet_file, line, "Expected the name of the trace file");
+
+        if (input_aet_file.line != line || !end_of_line(&input_aet_file))
+            parse_error(&input_aet_file, line, "An execution time model has to be given on one line");
+
+        // Checking the parameters of the model.
+        if ((source.model == UNIFORM_AET && (source.params[0] > source.params[1] || source.params[1] > 1))
+            || (source.model == BETA_AET && (source.params[0] <= 0 || source.params[1] <= 0))
+            || (source.model == BIMODAL_AET && source.params[0] > 1)
+            || (source.model == MARKOV_AET && (source.params[0] > 1 || source.params[1] > 1)))
+            parse_error(&input_aet_file, line, "Invalid parameters of an execution time model");
+
+        // Finding the task in the task-set.
+        int sorted_task_num = -1;
+        for (int j = 0; j < num_tasks; j++)
+        {
+            if (tasks[j].task_num == task_num)
+                sorted_task_num = j;
+        }
+        if (sorted_task_num < 0)
+            continue;
+
+        if (source.model == TRACE_AET)
+        {
+            open_input_file(&source.trace, source.trace_file_name);
+            float value;
+            if (!scan_float(&source.trace, &value))
+                parse_error(&source.trace, source.trace.line, "A trace has to start with an execution time");
+            source.trace.pos = 0;
+            source.trace.line = 1;
+        }
+
+        aet_sources[sorted_task_num] = source;
+    }
+
+    close_input_file(&input_aet_file);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task number and the wcet of a job that is being released (the wcet of its task unless a what-if simulation changed it).
+ * Post-condition: Returns the actual execution time of the job (more than 0 and at most the wcet).
+ */
+float
+find_actual_execution_time(int sorted_task_num, float wcet)
+{
+    Aet_source *source = &aet_sources[sorted_task_num];
+    float min_ratio = MIN_PERCENT_EXECUTION / 100.0;
+    float ratio;
+
+    switch (source->model)
+    {
+        case BETA_AET:
+            ratio = min_ratio + (1 - min_ratio) * sample_beta(source->params[0], source->params[1]);
+            break;
+
+        case BIMODAL_AET:
+            ratio = (random_uniform() < source->params[0]) ? source->params[2] : source->params[1];
+            ratio += source->params[3] * sample_normal();
+            break;
+
+        case MARKOV_AET:
+            // The mode changes with the probability of leaving the mode of the previous job.
+            if (random_uniform() < source->params[source->state])
+                source->state = !source->state;
+            ratio = source->params[2 + source->state] + source->params[4] * sample_normal();
+            break;
+
+        case TRACE_AET:
+            ratio = next_trace_value(source) / wcet;
+            break;
+
+        default:
+            // The default model is the same as the original one (MIN_PERCENT_EXECUTION to 100% in steps of 1%).
+            if (source->params[0] == min_ratio && source->params[1] == 1)
+            {
+                ratio = next_random() % (100 - MIN_PERCENT_EXECUTION);
+                ratio = (ratio + MIN_PERCENT_EXECUTION) / 100;
+            }
+            else
+                ratio = source->params[0] + (source->params[1] - source->params[0]) * random_uniform();
+            break;
+    }
+
+    // A job can neither run for longer than its wcet nor finish without running.
+    if (ratio > 1 || ratio <= 0)
+    {
+        source->num_clamped++;
+        ratio = (ratio > 1) ? 1 : 0.01;
+    }
+
+    return ratio * wcet;
+}
+
+
+/*
+ * Pre-condition: The two (positive) shape parameters.
+ * Post-condition: A psuedo-random number in [0, 1] from the beta distribution, as X / (X + Y) for gamma distributed X and Y.
+ */
+float
+sample_beta(float alpha, float beta)
+{
+    float x = sample_gamma(alpha);
+    float y = sample_gamma(beta);
+
+    return x / (x + y);
+}
+
+
+/*
+ * Pre-condition: A positive shape parameter.
+ * Post-condition: A psuedo-random number from the gamma distribution (Marsaglia and Tsang's method).
+ */
+float
+sample_gamma(float shape)
+{
+    // A shape less than 1 is boosted to shape + 1 and scaled back.
+    if (shape < 1)
+        return sample_gamma(shape + 1) * pow(random_uniform(), 1.0 / shape);
+
+    double d = shape - 1.0 / 3;
+    double c = 1 / sqrt(9 * d);
+    while (1)
+    {
+        double x = sample_normal();
+        double v = 1 + c * x;
+        if (v <= 0)
+            continue;
+
+        v = v * v * v;
+        if (log(random_uniform()) < 0.5 * x * x + d - d * v + d * log(v))
+            return d * v;
+    }
+}
+
+
+/*
+ * Pre-condition: A seeded psuedo-random number generator.
+ * Post-condition: A psuedo-random number from the standard normal distribution (Box-Muller transform).
+ */
+float
+sample_normal()
+{
+    return sqrt(-2 * log(random_uniform())) * cos(2 * M_PI * random_uniform());
+}
+
+
+/*
+ * Pre-condition: The model of a task with a memory-mapped trace.
+ * Post-condition: Returns the next execution time of the trace. The trace starts again once it is over.
+ */
+float
+next_trace_value(Aet_source *source)
+{
+    float value;
+    if (!scan_float(&source->trace, &value))
+    {
+        // The rest of the trace has to be whitespace.
+        skip_whitespace(&source->trace);
+        if (source->trace.pos < source->trace.size)
+            parse_error(&source->trace, source->trace.line, "Invalid execution time in the trace");
+
+        source->trace.pos = 0;
+        source->trace.line = 1;
+        scan_float(&source->trace, &value);
+    }
+    source->num_trace_values++;
+
+    return value;
+}
+
+
+/*
+ * Pre-condition: The models of the tasks.
+ * Post-condition: Prints the model of every task onto the output file.
+ */
+void
+print_aet_sources()
+{
+    fprintf(output_file, "------------------------------------------------------------\n");
+    fprintf(output_file, "Execution time models:\n");
+    for (int i = 0; i < num_tasks; i++)
+    {
+        Aet_source source = aet_sources[i];
+        fprintf(output_file, "Task-%d: %s", tasks[i].task_num, aet_model_names[source.model]);
+        if (source.model == TRACE_AET)
+            fprintf(output_file, " (%s)", source.trace_file_name);
+        for (int j = 0; j < aet_model_num_params[source.model]; j++)
+            fprintf(output_file, " %0.2f", source.params[j]);
+        fprintf(output_file, "\n");
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The models of the tasks after the scheduler has finished.
+ * Post-condition: Prints how many execution times were replayed from the traces and how many were clamped onto the statistics file.
+ */
+void
+print_aet_statistics()
+{
+    if (!AET_MODELS_FROM_FILE)
+        return;
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Execution time model statistics:\n");
+    for (int i = 0; i < num_tasks; i++)
+    {
+        fprintf(statistics_file, "Task-%d: %s model", tasks[i].task_num, aet_model_names[aet_sources[i].model]);
+        if (aet_sources[i].model == TRACE_AET)
+            fprintf(statistics_file, ", %ld execution times replayed from %s", aet_sources[i].num_trace_values, aet_sources[i].trace_file_name);
+        fprintf(statistics_file, ", %ld execution times clamped to (0, wcet]\n", aet_sources[i].num_clamped);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The models of the tasks.
+ * Post-condition: Unmaps the traces and frees the models.
+ */
+void
+delete_aet_sources()
+{
+    for (int i = 0; i < num_tasks; i++)
+    {
+        if (aet_sources[i].model == TRACE_AET)
+            close_input_file(&aet_sources[i].trace);
+    }
+
+    free(aet_sources);
+    aet_sources = NULL;
+
+    return;
+}
@@ -0,0 +1,35 @@
+#include "parser.h"
+
+// Models of the actual execution times of the jobs of a task.
+#define UNIFORM_AET 0 // Uniformly distributed between two ratios of the wcet (MIN_PERCENT_EXECUTION to 100% unless given).
+#define BETA_AET 1 // Beta distributed between MIN_PERCENT_EXECUTION and 100% of the wcet.
+#define BIMODAL_AET 2 // Around one of two ratios of the wcet, independently for every job.
+#define MARKOV_AET 3 // Around one of two ratios of the wcet, with the mode of the next job depending on the mode of the previous one.
+#define TRACE_AET 4 // Replayed from a trace of measured execution times (cycled if it is shorter than the schedule).
+
+#define AET_MODEL_NAME_LENGTH 16
+#define AET_TRACE_FILE_NAME_LENGTH 256
+
+typedef struct
+{
+    int model;
+    float params[5]; // Parameters of the model (see the input file of the models).
+    int state; // Mode of the previous job of a Markov-modulated task (0 = low, 1 = high).
+    char trace_file_name[AET_TRACE_FILE_NAME_LENGTH];
+    Input_file trace; // Memory-mapped trace (its read position is the next execution time to be replayed).
+    long num_trace_values; // Execution times replayed from the trace.
+    long num_clamped; // Execution times that were more than the wcet (or not positive) and were clamped.
+}
+Aet_source;
+
+// Functions.
+void init_aet_sources(); // Reads the models of the tasks (if any) and opens their traces.
+void input_aet_sources(); // Reads the model of every task given in the input file.
+float find_actual_execution_time(int, float); // The actual execution time of the next job of a task (relative to the wcet of the job).
+float sample_beta(float, float); // A psuedo-random number from a beta distribution.
+float sample_gamma(float); // A psuedo-random number from a gamma distribution with unit scale.
+float sample_normal(); // A psuedo-random number from the standard normal distribution.
+float next_trace_value(Aet_source *); // The next execution time of a trace (from the start once the trace is over).
+void print_aet_sources(); // Prints the model of every task.
+void print_aet_statistics(); // Prints the replayed and clamped execution times of every task.
+void delete_aet_sources(); // Unmaps the traces and frees the models.
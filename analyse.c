@@ -0,0 +1,418 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "taskset_cache.h"
+#include "schedule_log.h"
+
+/*
+ * Offline analyser of a schedule log written by the simulator (with SCHEDULE_LOG = 1).
+ *
+ * Usage: ./analyse [schedule log] [window length] [window start] [window end]
+ *
+ * The log is read one record at a time, so its size does not matter. The totals and the per-task statistics are the same as in the statistics
+ * file of the simulation. With a window length, the busy, overhead and idle time, energy, average frequency, completions, deadline misses and
+ * preemptions of every window between the window start and end (by default the whole schedule) are printed as well.
+ */
+
+// Statistics of one task, accumulated over its jobs.
+typedef struct
+{
+    long num_releases;
+    long num_finished;
+    long num_deadline_misses;
+    long num_preemptions;
+
+    // Response, execution and waiting time, frequency and dynamic energy of the finished jobs.
+    float sum[5];
+    float min[5];
+    float max[5];
+
+    // Response time jitter (the relative jitter needs only the first and the previous response times).
+    float first_response_time;
+    float prev_response_time;
+    float max_relative_rtj;
+}
+Task_summary;
+
+#define RESPONSE_TIME 0
+#define EXECUTION_TIME 1
+#define WAITING_TIME 2
+#define EXECUTION_FREQ 3
+#define DYNAMIC_ENERGY 4
+
+// Metrics of one window of the schedule.
+typedef struct
+{
+    float busy_time;
+    float overhead_time;
+    float idle_time;
+    float energy; // Dynamic and overhead energy.
+    float freq_time; // Frequency * busy time (for the average frequency).
+    long num_completions;
+    long num_deadline_misses;
+    long num_preemptions;
+}
+Window_summary;
+
+static Schedule_log_header header;
+static Cached_task *log_tasks;
+static Freq_and_voltage *log_freq_and_voltage;
+static Task_summary *task_summaries;
+
+// Totals of the schedule (the same as those of start_scheduler()).
+static float total_dynamic_energy, total_overhead_energy, total_static_energy, total_idle_energy, total_sleep_energy, total_transition_energy;
+static float total_idle_time, total_sleep_time, total_aet, total_wcet;
+static long num_context_switches, num_preemptions, num_cache_impact_points, num_freq_calculations, num_freq_changes, num_deadline_misses, num_finished_jobs;
+static long num_records;
+
+// Windows (only the windows in [window_start, window_end) are kept).
+static float window_length, window_start, window_end;
+static int num_windows;
+static Window_summary *windows;
+
+
+/*
+ * Pre-condition: An interval of the schedule and the metrics it adds per unit of time.
+ * Post-condition: The metrics are added to every window the interval overlaps, in proportion to the overlap.
+ */
+static void
+add_to_windows(float start, float end, float busy, float overhead, float idle, float power, float freq)
+{
+    if (num_windows == 0 || end <= start)
+        return;
+
+    if (start < window_start)
+        start = window_start;
+    if (end > window_end)
+        end = window_end;
+
+    for (int i = (int) ((start - window_start) / window_length); i < num_windows && start < end; i++)
+    {
+        float window_end_time = window_start + (i + 1) * window_length;
+        float time = ((end < window_end_time) ? end : window_end_time) - start;
+
+        windows[i].busy_time += busy * time;
+        windows[i].overhead_time += overhead * time;
+        windows[i].idle_time += idle * time;
+        windows[i].energy += power * time;
+        windows[i].freq_time += freq * busy * time;
+
+        start = window_end_time;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The time of an event.
+ * Post-condition: The window of the event (NULL if it is not in any window).
+ */
+static Window_summary *
+find_window(float time)
+{
+    if (num_windows == 0 || time < window_start || time >= window_end)
+        return NULL;
+
+    int i = (int) ((time - window_start) / window_length);
+    return (i < num_windows) ? &windows[i] : NULL;
+}
+
+
+/*
+ * Pre-condition: The statistics of a task and one value of a finished job.
+ * Post-condition: The value is added to the sum, minimum and maximum of its kind.
+ */
+static void
+add_task_value(Task_summary *summary, int kind, float value)
+{
+    summary->sum[kind] += value;
+    if (value < summary->min[kind])
+        summary->min[kind] = value;
+    if (value > summary->max[kind])
+        summary->max[kind] = value;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The header, tasks and frequency levels of the log.
+ * Post-condition: Adds one record to the totals, the statistics of its task and the windows.
+ */
+static void
+analyse_record(const Log_record *record)
+{
+    Task_summary *task = (record->task < header.num_tasks) ? &task_summaries[record->task] : NULL;
+    Freq_and_voltage level = log_freq_and_voltage[(record->level < header.num_freq_levels) ? record->level : 0];
+    float time = record->end - record->start;
+    Window_summary *window;
+
+    switch (record->type)
+    {
+        case LOG_JOB_RELEASE:
+            if (task)
+                task->num_releases++;
+            break;
+
+        case LOG_JOB_SEGMENT:
+            total_dynamic_energy += record->energy;
+            total_static_energy += level.static_power * time;
+            add_to_windows(record->start, record->end, 1, 0, 0, level.dynamic_power, level.freq);
+            break;
+
+        case LOG_JOB_COMPLETION:
+            num_finished_jobs++;
+            total_aet += record->value;
+            if (task)
+            {
+                float response_time = record->end - record->start;
+                if (task->num_finished == 0)
+                    task->first_response_time = response_time;
+                else if (fabsf(response_time - task->prev_response_time) > task->max_relative_rtj)
+                    task->max_relative_rtj = fabsf(response_time - task->prev_response_time);
+                task->prev_response_time = response_time;
+
+                task->num_finished++;
+                total_wcet += log_tasks[record->task].wcet;
+                add_task_value(task, RESPONSE_TIME, response_time);
+                add_task_value(task, EXECUTION_TIME, record->value);
+                add_task_value(task, WAITING_TIME, response_time - record->value);
+                add_task_value(task, EXECUTION_FREQ, level.freq);
+                add_task_value(task, DYNAMIC_ENERGY, record->energy);
+            }
+            if ((window = find_window(record->end)))
+                window->num_completions++;
+            break;
+
+        case LOG_OVERHEAD:
+            total_overhead_energy += record->energy;
+            total_static_energy += level.static_power * time;
+            add_to_windows(record->start, record->end, 0, 1, 0, (time > 0) ? record->energy / time : 0, 0);
+            break;
+
+        case LOG_FREQUENCY_CALCULATION:
+            num_freq_calculations++;
+            break;
+
+        case LOG_FREQUENCY_CHANGE:
+            num_freq_changes++;
+            break;
+
+        case LOG_IDLE:
+            if (record->level == 0)
+            {
+                total_idle_energy += record->energy;
+                total_idle_time += time;
+            }
+            else
+            {
+                total_sleep_energy += record->energy;
+                total_transition_energy += record->value;
+                total_sleep_time += time;
+            }
+            add_to_windows(record->start, record->end, 0, 0, 1, 0, 0);
+            break;
+
+        case LOG_DEADLINE_MISS:
+            num_deadline_misses++;
+            if (task)
+                task->num_deadline_misses++;
+            if ((window = find_window(record->start)))
+                window->num_deadline_misses++;
+            break;
+
+        case LOG_PREEMPTION:
+            num_preemptions++;
+            for (int i = 0; i < header.num_tasks; i++)
+            {
+                if (log_tasks[i].task_num == (int) record->value)
+                    task_summaries[i].num_preemptions++;
+            }
+            if ((window = find_window(record->start)))
+                window->num_preemptions++;
+            break;
+
+        case LOG_CONTEXT_SWITCH:
+            num_context_switches++;
+            if (record->value)
+                num_cache_impact_points++;
+            break;
+
+        case LOG_CACHE_IMPACT_POINT:
+            num_cache_impact_points++;
+            break;
+
+        default:
+            fprintf(stderr, "ERROR: Invalid record (type %d) at record %ld of the schedule log.\n", record->type, num_records);
+            exit(0);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The schedule log, opened right at its start.
+ * Post-condition: The header, the tasks and the frequency levels are read (and checked).
+ */
+static void
+read_log_header(FILE *log_file)
+{
+    if (fread(&header, sizeof(header), 1, log_file) != 1 || memcmp(header.magic, SCHEDULE_LOG_MAGIC, sizeof(SCHEDULE_LOG_MAGIC)) != 0 || header.num_tasks < 0 || header.num_tasks >= LOG_NO_TASK || header.num_freq_levels <= 0)
+    {
+        fprintf(stderr, "ERROR: Not a schedule log (or one of another format version).\n");
+        exit(0);
+    }
+
+    log_tasks = (Cached_task *) calloc(header.num_tasks + 1, sizeof(Cached_task));
+    log_freq_and_voltage = (Freq_and_voltage *) calloc(header.num_freq_levels, sizeof(Freq_and_voltage));
+    if (fread(log_tasks, sizeof(Cached_task), header.num_tasks, log_file) != (size_t) header.num_tasks || fread(log_freq_and_voltage, sizeof(Freq_and_voltage), header.num_freq_levels, log_file) != (size_t) header.num_freq_levels)
+    {
+        fprintf(stderr, "ERROR: The schedule log ends in its header.\n");
+        exit(0);
+    }
+
+    task_summaries = (Task_summary *) calloc(header.num_tasks + 1, sizeof(Task_summary));
+    for (int i = 0; i < header.num_tasks; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            task_summaries[i].min[j] = FLT_MAX;
+            task_summaries[i].max[j] = -FLT_MAX;
+        }
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The statistics of every task after the whole log has been read.
+ * Post-condition: Prints the totals and the per-task statistics (in the same format as the statistics file).
+ */
+static void
+print_statistics()
+{
+    const char *names[5] = {"Response time", "Execution time", "Waiting time", "Execution frequency", "Dynamic Energy"};
+
+    printf("------------------------------------------------------------\n");
+    printf("Schedule log of core %d (%ld records, scheduled from t=0 to t=%ld).\n", header.core_num, num_records, header.end_of_execution_time);
+    printf("Random seed: %llu\n", header.seed);
+    printf("Total dynamic-energy consumer: %0.2f\n", total_dynamic_energy);
+    printf("Total overhead-energy consumed: %0.2f\n", total_overhead_energy);
+    printf("Total static-energy consumed: %0.2f\n", total_static_energy);
+    printf("Total idle-energy consumed: %0.2f (idle for %0.2f units of time)\n", total_idle_energy, total_idle_time);
+    printf("Total sleep-energy consumed: %0.2f (sleeping for %0.2f units of time)\n", total_sleep_energy, total_sleep_time);
+    printf("Total transition-energy consumed: %0.2f\n", total_transition_energy);
+    printf("Total energy consumed: %0.2f\n", total_dynamic_energy + total_overhead_energy + total_static_energy + total_idle_energy + total_sleep_energy + total_transition_energy);
+    printf("Weighted average percentage of execution of jobs: %0.1f\n", (total_wcet > 0) ? total_aet / total_wcet * 100 : 0);
+    printf("Total number of context-switches: %ld\n", num_context_switches);
+    printf("Total number of preemptions: %ld\n", num_preemptions);
+    printf("Total number of cache-impact points: %ld\n", num_cache_impact_points);
+    printf("Total number of frequency calculations: %ld\n", num_freq_calculations);
+    printf("Total number of frequency changes: %ld\n", num_freq_changes);
+    printf("Total number of deadline misses: %ld\n", num_deadline_misses);
+    printf("Number of finished jobs: %ld\n", num_finished_jobs);
+
+    printf("------------------------------------------------------------\n");
+    printf("Task statistics (averages over the instances of the task, as in the statistics file).\n");
+    for (int i = 0; i < header.num_tasks; i++)
+    {
+        Task_summary task = task_summaries[i];
+        int num_instances = (log_tasks[i].num_instances > 0) ? log_tasks[i].num_instances : 1;
+
+        printf("Task-%d: Released: %ld, Finished: %ld/%d, Deadline misses: %ld, Preemptions: %ld\n", log_tasks[i].task_num, task.num_releases, task.num_finished, log_tasks[i].num_instances, task.num_deadline_misses, task.num_preemptions);
+        if (task.num_finished == 0)
+            continue;
+
+        for (int j = 0; j < 5; j++)
+            printf("\t%s (Max: %0.2f, Min: %0.2f, Avg: %0.2f)\n", names[j], task.max[j], task.min[j], task.sum[j] / num_instances);
+
+        // As after the hyperperiod the first instance runs again, the relative jitter includes the last and the first instance.
+        float relative_rtj = task.max_relative_rtj;
+        if (fabsf(task.first_response_time - task.prev_response_time) > relative_rtj)
+            relative_rtj = fabsf(task.first_response_time - task.prev_response_time);
+        printf("\tAbsolute RTJ: %0.2f, Relative RTJ: %0.2f\n", task.max[RESPONSE_TIME] - task.min[RESPONSE_TIME], relative_rtj);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The metrics of every window.
+ * Post-condition: Prints one line per window.
+ */
+static void
+print_windows()
+{
+    if (num_windows == 0)
+        return;
+
+    printf("------------------------------------------------------------\n");
+    printf("Windows of %0.2f units of time from t=%0.2f to t=%0.2f.\n", window_length, window_start, window_end);
+    printf("%10s %10s %10s %10s %10s %10s %10s %12s %8s %10s\n", "Start", "Busy", "Overhead", "Idle", "Energy", "Avg freq", "Util", "Completions", "Misses", "Preempts");
+    for (int i = 0; i < num_windows; i++)
+    {
+        Window_summary window = windows[i];
+        float length = ((i + 1) * window_length < window_end - window_start) ? window_length : window_end - window_start - i * window_length;
+
+        printf("%10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %12ld %8ld %10ld\n", window_start + i * window_length, window.busy_time, window.overhead_time, window.idle_time, window.energy, (window.busy_time > 0) ? window.freq_time / window.busy_time : 0, (length > 0) ? (window.busy_time + window.overhead_time) / length : 0, window.num_completions, window.num_deadline_misses, window.num_preemptions);
+    }
+
+    return;
+}
+
+
+int main(int argc, char const *argv[])
+{
+    const char *log_file_name = (argc > 1) ? argv[1] : OUTPUT_SCHEDULE_LOG_FILE_NAME;
+    FILE *log_file = fopen(log_file_name, "rb");
+    if (!log_file)
+    {
+        fprintf(stderr, "ERROR: Could not open the schedule log %s.\n", log_file_name);
+        exit(0);
+    }
+    setvbuf(log_file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+    read_log_header(log_file);
+
+    // Windows (by default over the whole schedule).
+    window_length = (argc > 2) ? atof(argv[2]) : 0;
+    window_start = (argc > 3) ? atof(argv[3]) : 0;
+    window_end = (argc > 4) ? atof(argv[4]) : header.end_of_execution_time;
+    if (window_length > 0 && window_end > window_start)
+    {
+        num_windows = (int) ((window_end - window_start) / window_length);
+        if (window_start + num_windows * window_length < window_end)
+            num_windows++;
+        windows = (Window_summary *) calloc(num_windows, sizeof(Window_summary));
+    }
+
+    // The records are streamed through one buffer.
+    Log_record record;
+    while (fread(&record, sizeof(record), 1, log_file) == 1)
+    {
+        num_records++;
+        analyse_record(&record);
+    }
+    fclose(log_file);
+
+    print_statistics();
+    print_windows();
+
+    free(windows);
+    free(task_summaries);
+    free(log_freq_and_voltage);
+    free(log_tasks);
+
+    return 0;
+}
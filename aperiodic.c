@@ -0,0 +1,542 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "utility.h"
+#include "parser.h"
+#include "event_calendar.h"
+#include "scheduler.h"
+#include "aperiodic.h"
+
+// Global variables required to serve the aperiodic and sporadic jobs.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+
+// Tasks and jobs.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local Job *jobs;
+
+// Related to the ready queue.
+extern _Thread_local Job *ready_queue;
+extern _Thread_local int num_job_in_ready_queue;
+
+extern _Thread_local long end_of_execution_time;
+extern _Thread_local float current_time;
+extern unsigned long long simulation_seed;
+
+// The arrival stream (sorted based on arrival time). The jobs from next_aperiodic_job_to_serve to num_aperiodic_jobs_arrived - 1 are waiting in FIFO order.
+_Thread_local Aperiodic_job *aperiodic_jobs;
+_Thread_local int num_aperiodic_jobs;
+_Thread_local int num_aperiodic_jobs_arrived;
+_Thread_local int next_aperiodic_job_to_serve;
+_Thread_local float pending_aperiodic_work; // Sum of the execution left of all the waiting jobs.
+
+// State of the server.
+_Thread_local int server_task_num; // The server is the last task of the input (task number = number of input tasks).
+_Thread_local int latest_server_job; // Index of the latest released server job in the jobs array (-1 if none is released yet).
+_Thread_local int server_active; // Whether a server job is in the ready queue.
+_Thread_local float server_budget;
+_Thread_local float server_activation_time; // Used by the sporadic server to find when the budget it consumes is replenished.
+_Thread_local float server_budget_consumed; // Budget consumed by the sporadic server since it became active.
+
+// Budgets that the sporadic server gets back (the calendar event of a replenishment holds its index).
+_Thread_local float *replenishment_amounts;
+_Thread_local int num_replenishments;
+
+
+/*
+ * Pre-condition: None.
+ * Post-condition: Returns 1 if aperiodic and sporadic jobs are served by a server, 0 otherwise.
+ *
+ * The server is only supported by the uniprocessor scheduler.
+ */
+int
+server_enabled()
+{
+    return APERIODIC_SERVER != NO_SERVER && NUM_CORES == 1;
+}
+
+
+/*
+ * Pre-condition: Task array with space for one more task, containing all the input tasks.
+ * Post-condition: The server is added as the last task, so that it is scheduled (and analysed) like any other periodic task.
+ */
+void
+add_server_task()
+{
+    tasks[num_tasks].task_num = num_tasks;
+    tasks[num_tasks].phase = 0;
+    tasks[num_tasks].period = SERVER_PERIOD;
+    tasks[num_tasks].wcet = SERVER_BUDGET;
+    tasks[num_tasks].deadline = SERVER_PERIOD;
+    num_tasks++;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A task number.
+ * Post-condition: Returns 1 if the task is the server, 0 otherwise.
+ */
+int
+is_server_task(int task_num)
+{
+    return server_enabled() && task_num == server_task_num;
+}
+
+
+/*
+ * Pre-condition: Task-set containing the server task and an initialised event calendar.
+ * Post-condition: The arrival stream is read or generated, the server gets its initial budget and the first arrival is in the event calendar.
+ */
+void
+init_aperiodic_jobs()
+{
+    aperiodic_jobs = NULL;
+    num_aperiodic_jobs = 0;
+    num_aperiodic_jobs_arrived = 0;
+    next_aperiodic_job_to_serve = 0;
+    pending_aperiodic_work = 0;
+    replenishment_amounts = NULL;
+    num_replenishments = 0;
+
+    if (!server_enabled())
+        return;
+
+    server_task_num = num_tasks - 1;
+    latest_server_job = -1;
+    server_active = 0;
+    server_budget_consumed = 0;
+
+    // A polling or deferrable server gets its budget at the start of every period, a sporadic server starts with its full budget.
+    server_budget = (APERIODIC_SERVER == SPORADIC_SERVER) ? SERVER_BUDGET : 0;
+
+    if (APERIODIC_ARRIVALS_FROM_FILE)
+        input_aperiodic_jobs();
+    else
+        generate_aperiodic_jobs();
+
+    fprintf(output_file, "------------------------------------------------------------\n");
+    fprintf(output_file, "Server: Task-%d, Period: %d, Budget: %0.2f. Number of aperiodic and sporadic jobs: %d\n", server_task_num, SERVER_PERIOD, SERVER_BUDGET, num_aperiodic_jobs);
+
+    if (num_aperiodic_jobs > 0)
+        schedule_calendar_event(aperiodic_jobs[0].arrival_time, CALENDAR_APERIODIC_ARRIVAL, 0);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An input file with the number of jobs followed by the arrival time, execution time and an optional relative deadline of every job (one job per line, sorted based on arrival time).
+ * Post-condition: The arrival stream is initialised from the file.
+ */
+void
+input_aperiodic_jobs()
+{
+    Input_file input_aperiodic_file;
+    open_input_file(&input_aperiodic_file, INPUT_APERIODIC_FILE_NAME);
+
+    long num_jobs_input;
+    if (!scan_long(&input_aperiodic_file, &num_jobs_input) || num_jobs_input < 0)
+        parse_error(&input_aperiodic_file, input_aperiodic_file.line, "Invalid number of aperiodic jobs");
+    num_aperiodic_jobs = num_jobs_input;
+
+    aperiodic_jobs = (Aperiodic_job *) malloc(sizeof(Aperiodic_job) * num_aperiodic_jobs);
+
+    for (int i = 0; i < num_aperiodic_jobs; i++) // Iterates over all the jobs.
+    {
+        Aperiodic_job *job = &aperiodic_jobs[i];
+
+        // Every job is on its own line.
+        skip_whitespace(&input_aperiodic_file);
+        int line = input_aperiodic_file.line;
+
+        if (!scan_float(&input_aperiodic_file, &job->arrival_time) || !scan_float(&input_aperiodic_file, &job->execution_time))
+            parse_error(&input_aperiodic_file, line, "Expected the arrival time and execution time of an aperiodic job");
+
+        // A sporadic job also has a relative deadline.
+        job->absolute_deadline = -1;
+        long relative_deadline;
+        if (input_aperiodic_file.line == line && !end_of_line(&input_aperiodic_file))
+        {
+            if (!scan_long(&input_aperiodic_file, &relative_deadline) || relative_deadline <= 0)
+                parse_error(&input_aperiodic_file, line, "Invalid relative deadline of a sporadic job");
+            job->absolute_deadline = job->arrival_time + relative_deadline;
+        }
+
+        if (input_aperiodic_file.line != line || !end_of_line(&input_aperiodic_file))
+            parse_error(&input_aperiodic_file, line, "An aperiodic job has to be given as two or three values on one line");
+
+        if (job->arrival_time < 0 || job->execution_time <= 0 || (i > 0 && job->arrival_time < aperiodic_jobs[i - 1].arrival_time))
+            parse_error(&input_aperiodic_file, line, "Invalid aperiodic job input (arrival times have to be non-decreasing)");
+
+        job->request_num = i;
+        job->time_left = job->execution_time;
+        job->finish_time = -1;
+    }
+
+    close_input_file(&input_aperiodic_file);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The end of execution time.
+ * Post-condition: The arrival stream till the end of execution is generated using the configured arrival model.
+ *
+ * The stream is drawn from its own psuedo-random sequence, so the execution times of the periodic jobs are the same with or without the server.
+ */
+void
+generate_aperiodic_jobs()
+{
+    seed_random(~simulation_seed);
+
+    int capacity = 16;
+    aperiodic_jobs = (Aperiodic_job *) malloc(sizeof(Aperiodic_job) * capacity);
+
+    float arrival_time = 0;
+    while (1)
+    {
+        // Exponentially distributed inter-arrival times (shifted by the minimum inter-arrival time of sporadic jobs).
+        if (APERIODIC_ARRIVAL_MODEL == MIN_INTERARRIVAL_ARRIVALS)
+            arrival_time += SPORADIC_MIN_INTERARRIVAL - (APERIODIC_MEAN_INTERARRIVAL - SPORADIC_MIN_INTERARRIVAL) * log(random_uniform());
+        else
+            arrival_time += -APERIODIC_MEAN_INTERARRIVAL * log(random_uniform());
+
+        if (arrival_time >= end_of_execution_time)
+            break;
+
+        if (num_aperiodic_jobs == capacity)
+        {
+            capacity *= 2;
+            aperiodic_jobs = (Aperiodic_job *) realloc(aperiodic_jobs, sizeof(Aperiodic_job) * capacity);
+        }
+
+        // Execution time = (MIN_PERCENT_EXECUTION to 100)% of the maximum execution time (the same as the periodic jobs).
+        float execution_time = next_random() % (100 - MIN_PERCENT_EXECUTION);
+        execution_time = (execution_time + MIN_PERCENT_EXECUTION) / 100 * APERIODIC_MAX_EXECUTION;
+
+        Aperiodic_job *job = &aperiodic_jobs[num_aperiodic_jobs];
+        job->request_num = num_aperiodic_jobs;
+        job->arrival_time = arrival_time;
+        job->execution_time = execution_time;
+        job->time_left = execution_time;
+        job->absolute_deadline = (APERIODIC_ARRIVAL_MODEL == MIN_INTERARRIVAL_ARRIVALS) ? arrival_time + SPORADIC_RELATIVE_DEADLINE : -1;
+        job->finish_time = -1;
+        num_aperiodic_jobs++;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: None.
+ * Post-condition: Returns the index of the server job in the ready queue (-1 if the server is not active).
+ */
+static int
+find_server_in_ready_queue()
+{
+    for (int i = 0; i < num_job_in_ready_queue; i++)
+    {
+        if (ready_queue[i].task_num == server_task_num)
+            return i;
+    }
+
+    return -1;
+}
+
+
+/*
+ * Pre-condition: The index of an aperiodic or sporadic job that has just arrived.
+ * Post-condition: The job waits for the server, which is activated if it has budget left. The next arrival is added to the event calendar.
+ */
+void
+aperiodic_job_arrival(int index)
+{
+    num_aperiodic_jobs_arrived = index + 1;
+    pending_aperiodic_work += aperiodic_jobs[index].execution_time;
+
+    fprintf(output_file, "Aperiodic job A%d: Arrived at t=%0.2f. Execution time: %0.2f. Pending aperiodic work: %0.2f\n", index, current_time, aperiodic_jobs[index].execution_time, pending_aperiodic_work);
+
+    if (index + 1 < num_aperiodic_jobs)
+        schedule_calendar_event(aperiodic_jobs[index + 1].arrival_time, CALENDAR_APERIODIC_ARRIVAL, index + 1);
+
+    // A polling server that is not active has lost its budget till its next period.
+    if (server_active || APERIODIC_SERVER != POLLING_SERVER)
+        activate_server();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The index of a replenishment of the sporadic server that is due.
+ * Post-condition: The budget is replenished and the server is activated if there is work waiting.
+ */
+void
+server_replenishment(int index)
+{
+    server_budget += replenishment_amounts[index];
+    if (server_budget > SERVER_BUDGET)
+        server_budget = SERVER_BUDGET;
+
+    fprintf(output_file, "Sporadic server replenished by %0.2f at t=%0.2f. Budget: %0.2f\n", replenishment_amounts[index], current_time, server_budget);
+
+    activate_server();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A server job that has just been released (before it is added to the ready queue).
+ * Post-condition: Returns 1 if the job has to be added to the ready queue (with its execution time set to the work the server can do), 0 otherwise.
+ *
+ * A server job that is not added to the ready queue is marked as finished without executing.
+ */
+int
+release_server_job(Job *job)
+{
+    latest_server_job = job->job_index;
+
+    // Polling and deferrable servers get their full budget back at the start of every period.
+    if (APERIODIC_SERVER != SPORADIC_SERVER)
+        server_budget = SERVER_BUDGET;
+
+    // The execution of a server job is accumulated over all the times it runs in its period.
+    jobs[job->job_index].aet = 0;
+    jobs[job->job_index].time_executed = 0;
+
+    int index = find_server_in_ready_queue();
+    if (index >= 0 || pending_aperiodic_work < SERVER_TIME_EPSILON || server_budget < SERVER_TIME_EPSILON)
+    {
+        // The server job that is still in the ready queue does the work of this period as well.
+        if (index >= 0)
+            activate_server();
+        else if (APERIODIC_SERVER == POLLING_SERVER) // A polling server with no waiting work gives up its budget.
+            server_budget = 0;
+
+        jobs[job->job_index].finish_time = current_time;
+        jobs[job->job_index].alive = false;
+
+        fprintf(output_file, "Job J%d,%d: Server has no work of its own to do in this period. Budget: %0.2f\n", job->task_num, job->instance_num, server_budget);
+
+        return 0;
+    }
+
+    job->aet = (pending_aperiodic_work < server_budget) ? pending_aperiodic_work : server_budget;
+    job->time_left = job->aet;
+    server_active = 1;
+    server_activation_time = current_time;
+    server_budget_consumed = 0;
+
+    fprintf(output_file, "Job J%d,%d: Server active with budget %0.2f. Execution time left to finish: %0.2f\n", job->task_num, job->instance_num, server_budget, job->aet);
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: The state of the server and the waiting aperiodic and sporadic jobs.
+ * Post-condition: If the server is active, its job in the ready queue is given the work it can do now. Else if it has budget and there is work waiting, the latest server job is added to the ready queue again.
+ */
+void
+activate_server()
+{
+    if (pending_aperiodic_work < SERVER_TIME_EPSILON || server_budget < SERVER_TIME_EPSILON)
+        return;
+
+    float work = (pending_aperiodic_work < server_budget) ? pending_aperiodic_work : server_budget;
+
+    int index = find_server_in_ready_queue();
+    if (index >= 0) // Extending (or shortening) the execution of the active server.
+    {
+        ready_queue[index].aet += work - ready_queue[index].time_left;
+        ready_queue[index].time_left = work;
+        return;
+    }
+
+    if (latest_server_job < 0) // The server has not been released yet.
+        return;
+
+    // A deferrable or sporadic server preserves its budget, so the server job runs again (with the priority of the server).
+    Job job = jobs[latest_server_job];
+    job.alive = true;
+    job.aet = work;
+    job.time_left = work;
+    job.time_executed = 0;
+    job.time_next_execution = 0;
+    job.dynamic_energy_consumed = 0;
+    jobs[latest_server_job].alive = true;
+
+    num_job_in_ready_queue++;
+    ready_queue = (Job *) realloc(ready_queue, sizeof(Job) * num_job_in_ready_queue);
+    ready_queue[num_job_in_ready_queue - 1] = job;
+    insert_job_ready_queue();
+
+    server_active = 1;
+    server_activation_time = current_time;
+    server_budget_consumed = 0;
+
+    fprintf(output_file, "Job J%d,%d: Server activated again at t=%0.2f with budget %0.2f. Execution time left to finish: %0.2f\n", job.task_num, job.instance_num, current_time, server_budget, work);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The start and the length of an execution of the server.
+ * Post-condition: The waiting jobs are executed in FIFO order and the budget of the server is consumed.
+ */
+void
+serve_aperiodic_jobs(float start_time, float execution_time)
+{
+    server_budget -= execution_time;
+    if (server_budget < 0)
+        server_budget = 0;
+    server_budget_consumed += execution_time;
+
+    float time = start_time;
+    while (execution_time > 0 && next_aperiodic_job_to_serve < num_aperiodic_jobs_arrived)
+    {
+        Aperiodic_job *job = &aperiodic_jobs[next_aperiodic_job_to_serve];
+        float served = (job->time_left < execution_time) ? job->time_left : execution_time;
+
+        job->time_left -= served;
+        pending_aperiodic_work -= served;
+        execution_time -= served;
+        time += served;
+
+        if (job->time_left < SERVER_TIME_EPSILON) // The job has finished.
+        {
+            pending_aperiodic_work -= job->time_left;
+            job->time_left = 0;
+            job->finish_time = time;
+            next_aperiodic_job_to_serve++;
+
+            fprintf(output_file, "Aperiodic job A%d: Finished execution at t=%0.2f. Response time: %0.2f\n", job->request_num, time, time - job->arrival_time);
+        }
+    }
+
+    if (pending_aperiodic_work < 0)
+        pending_aperiodic_work = 0;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The server job has just finished (it ran out of budget or work).
+ * Post-condition: The server is suspended. The sporadic server gets back the budget it consumed one period after it became active.
+ */
+void
+complete_server_job()
+{
+    server_active = 0;
+
+    if (APERIODIC_SERVER == POLLING_SERVER) // A polling server suspends itself till its next period.
+        server_budget = 0;
+
+    if (APERIODIC_SERVER == SPORADIC_SERVER && server_budget_consumed > 0)
+    {
+        num_replenishments++;
+        replenishment_amounts = (float *) realloc(replenishment_amounts, sizeof(float) * num_replenishments);
+        replenishment_amounts[num_replenishments - 1] = server_budget_consumed;
+        schedule_calendar_event(server_activation_time + SERVER_PERIOD, CALENDAR_SERVER_REPLENISHMENT, num_replenishments - 1);
+        server_budget_consumed = 0;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: Two response times.
+ * Post-condition: Integer representing the answer of the comparison.
+ */
+static int
+compare_floats(const void *a, const void *b)
+{
+    float float_a = *((float *) a), float_b = *((float *) b);
+
+    return (float_a > float_b) - (float_a < float_b);
+}
+
+
+/*
+ * Pre-condition: The arrival stream after the scheduler has finished.
+ * Post-condition: Prints the number of served jobs, the response-time percentiles and the deadline misses of the sporadic jobs onto the statistics file.
+ */
+void
+print_aperiodic_statistics()
+{
+    if (!server_enabled())
+        return;
+
+    const char *server_names[] = {"None", "Polling server", "Deferrable server", "Sporadic server"};
+
+    float *response_times = (float *) malloc(sizeof(float) * (num_aperiodic_jobs + 1));
+    int num_served = 0, num_sporadic = 0, num_deadline_misses = 0;
+    float total_response_time = 0;
+
+    for (int i = 0; i < num_aperiodic_jobs; i++) // Iterates over every aperiodic and sporadic job.
+    {
+        Aperiodic_job job = aperiodic_jobs[i];
+
+        if (job.finish_time >= 0)
+        {
+            response_times[num_served] = job.finish_time - job.arrival_time;
+            total_response_time += response_times[num_served];
+            num_served++;
+        }
+
+        // A sporadic job misses its deadline if it did not finish by then (only the jobs whose deadline is within the simulation are counted).
+        if (job.absolute_deadline >= 0 && job.absolute_deadline <= end_of_execution_time)
+        {
+            num_sporadic++;
+            if (job.finish_time < 0 || job.finish_time > job.absolute_deadline)
+                num_deadline_misses++;
+        }
+    }
+
+    qsort(response_times, num_served, sizeof(float), compare_floats);
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Aperiodic job statistics (%s, Period: %d, Budget: %0.2f).\n", server_names[APERIODIC_SERVER], SERVER_PERIOD, SERVER_BUDGET);
+    fprintf(statistics_file, "Number of aperiodic jobs: %d, served: %d\n", num_aperiodic_jobs, num_served);
+    if (num_served > 0)
+    {
+        fprintf(statistics_file, "Response times: (Avg: %0.2f, P50: %0.2f, P90: %0.2f, P99: %0.2f, Max: %0.2f)\n", total_response_time / num_served, response_times[(num_served - 1) * 50 / 100], response_times[(num_served - 1) * 90 / 100], response_times[(num_served - 1) * 99 / 100], response_times[num_served - 1]);
+    }
+    if (num_sporadic > 0)
+        fprintf(statistics_file, "Sporadic deadline misses: %d of %d\n", num_deadline_misses, num_sporadic);
+
+    free(response_times);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The arrival stream.
+ * Post-condition: Frees the heap data related to the aperiodic jobs.
+ */
+void
+delete_aperiodic_jobs()
+{
+    free(aperiodic_jobs);
+    free(replenishment_amounts);
+    aperiodic_jobs = NULL;
+    replenishment_amounts = NULL;
+
+    return;
+}
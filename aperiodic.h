@@ -0,0 +1,29 @@
+// Amounts of execution and budget below this are treated as zero (to absorb floating point errors).
+#define SERVER_TIME_EPSILON 0.0001
+
+typedef struct
+{
+    int request_num;
+    float arrival_time;
+    float execution_time;
+    float time_left;
+    float absolute_deadline; // Negative for aperiodic jobs (which have no deadline).
+    float finish_time; // Negative till the job finishes.
+}
+Aperiodic_job;
+
+// Functions.
+int server_enabled(); // Whether aperiodic and sporadic jobs are served by a server task.
+void add_server_task(); // Adds the server task to the task-set (as the last task before sorting).
+int is_server_task(int); // Checks whether the given task number is the server task.
+void init_aperiodic_jobs(); // Reads or generates the arrival stream and initialises the server.
+void input_aperiodic_jobs(); // Reads the arrival stream from the input file.
+void generate_aperiodic_jobs(); // Generates the arrival stream using the configured arrival model.
+void aperiodic_job_arrival(int); // Handles the arrival of an aperiodic or sporadic job.
+void server_replenishment(int); // Handles the replenishment of the budget of a sporadic server.
+int release_server_job(Job *); // Decides whether a newly released server job has work and sets its execution time.
+void activate_server(); // Makes the server ready (or updates the ready server) with the work it can do now.
+void serve_aperiodic_jobs(float, float); // Executes the aperiodic and sporadic jobs in FIFO order while the server runs.
+void complete_server_job(); // Updates the state of the server once its job completes.
+void print_aperiodic_statistics(); // Prints the response-time statistics of the aperiodic and sporadic jobs.
+void delete_aperiodic_jobs(); // Frees the arrival stream.
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "scheduler.h"
+#include "dpm.h"
+#include "histogram.h"
+#include "baseline.h"
+
+// Data of the simulation running in the current thread.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
+extern _Thread_local long hyperperiod;
+extern _Thread_local long first_in_phase_time;
+extern _Thread_local long end_of_execution_time;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Level_transition *level_transitions;
+extern _Thread_local Freq_and_voltage static_freq_and_voltage;
+extern _Thread_local int static_freq_and_voltage_index;
+extern _Thread_local long num_freq_calculations;
+extern _Thread_local long num_freq_changes;
+extern _Thread_local float total_dynamic_energy;
+extern _Thread_local long num_context_switches;
+extern _Thread_local long num_preemptions;
+extern _Thread_local long num_deadline_misses;
+extern _Thread_local float total_overhead_time;
+extern _Thread_local float total_overhead_energy;
+
+// Copies of the data of the main thread that the baseline thread needs.
+static int shared_num_tasks;
+static Task *shared_tasks;
+static long shared_hyperperiod;
+static long shared_first_in_phase_time;
+static long shared_end_of_execution_time;
+static int shared_num_freq_levels;
+static Freq_and_voltage *shared_freq_and_voltage;
+static Level_transition *shared_level_transitions;
+static int shared_static_freq_and_voltage_index;
+static void (*disable_policies)(); // Turns off the policies being compared in the baseline thread.
+
+
+/*
+ * Pre-condition: A simulation that has just finished in the current thread.
+ * Post-condition: The summary holds the energy and the counters of the simulation.
+ */
+void
+summarise_simulation(Simulation_summary *summary)
+{
+    summary->total_dynamic_energy = total_dynamic_energy;
+    summary->total_energy = find_total_energy();
+    summary->num_freq_calculations = num_freq_calculations;
+    summary->num_freq_changes = num_freq_changes;
+    summary->num_context_switches = num_context_switches;
+    summary->num_preemptions = num_preemptions;
+    summary->total_overhead_time = total_overhead_time;
+    summary->total_overhead_energy = total_overhead_energy;
+    summary->num_deadline_misses = num_deadline_misses;
+
+    summary->num_finished_jobs = 0;
+    for (int i = 0; i < num_jobs; i++)
+    {
+        if (jobs[i].alive == false)
+            summary->num_finished_jobs++;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task-set, the frequencies and the metadata of the task-set. A function that turns off the policies to be compared.
+ * Post-condition: The same task-set is simulated with the same seed in its own thread (with the policies turned off), and the summary holds its results.
+ */
+void
+run_baseline_simulation(void (*disable)(), Simulation_summary *summary)
+{
+    shared_num_tasks = num_tasks;
+    shared_tasks = tasks;
+    shared_hyperperiod = hyperperiod;
+    shared_first_in_phase_time = first_in_phase_time;
+    shared_end_of_execution_time = end_of_execution_time;
+    shared_num_freq_levels = num_freq_levels;
+    shared_freq_and_voltage = freq_and_voltage;
+    shared_level_transitions = level_transitions;
+    shared_static_freq_and_voltage_index = static_freq_and_voltage_index;
+    disable_policies = disable;
+
+    // The policies are run-time flags of every thread, so the baseline runs in a thread of its own.
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, simulate_baseline, summary) != 0)
+    {
+        fprintf(stderr, "ERROR: Could not create the thread of the baseline simulation.\n");
+        exit(0);
+    }
+    pthread_join(thread, NULL);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The data of the main thread. (Runs in its own thread, so all the simulation data is thread-local.)
+ * Post-condition: Simulates the baseline schedule and stores its summary.
+ */
+void *
+simulate_baseline(void *arg)
+{
+    Simulation_summary *summary = (Simulation_summary *) arg;
+
+    num_tasks = shared_num_tasks;
+    tasks = (Task *) calloc(num_tasks, sizeof(Task));
+    memcpy(tasks, shared_tasks, sizeof(Task) * num_tasks);
+    hyperperiod = shared_hyperperiod;
+    first_in_phase_time = shared_first_in_phase_time;
+    end_of_execution_time = shared_end_of_execution_time;
+    num_freq_levels = shared_num_freq_levels;
+    freq_and_voltage = shared_freq_and_voltage;
+    level_transitions = shared_level_transitions;
+    static_freq_and_voltage_index = shared_static_freq_and_voltage_index;
+    static_freq_and_voltage = freq_and_voltage[static_freq_and_voltage_index];
+
+    output_file = fopen(OUTPUT_BASELINE_FILE_NAME, "w");
+    statistics_file = fopen(OUTPUT_BASELINE_STATISTICS_FILE_NAME, "w");
+    if (!output_file || !statistics_file)
+    {
+        fprintf(stderr, "ERROR: Could not open the required files.\n");
+        exit(0);
+    }
+
+    disable_policies();
+
+    fprintf(output_file, "Baseline simulation.\n");
+    create_sort_print_jobs();
+    start_scheduler();
+    summarise_simulation(summary);
+
+    fprintf(output_file, "\n--------------------------- THE END ---------------------------\n");
+    fprintf(statistics_file, "\n--------------------------- THE END ---------------------------\n");
+    fclose(output_file);
+    fclose(statistics_file);
+    delete_task_histograms();
+    delete_jobs();
+    delete_tasks();
+
+    return NULL;
+}
+
+
+/*
+ * Pre-condition: A simulation that has just finished in the current thread, a function that turns off the policies being evaluated and their name.
+ * Post-condition: Simulates the baseline and prints both the results side by side onto the statistics file.
+ */
+void
+compare_with_baseline(void (*disable)(), const char *policies)
+{
+    Simulation_summary current, baseline;
+    summarise_simulation(&current);
+    run_baseline_simulation(disable, &baseline);
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Comparison with the baseline (without %s). The baseline schedule is in %s.\n", policies, OUTPUT_BASELINE_FILE_NAME);
+    fprintf(statistics_file, "%-28s %12s %12s %12s\n", "", "Current", "Baseline", "Difference");
+    fprintf(statistics_file, "%-28s %12.2f %12.2f %+12.2f\n", "Dynamic energy", current.total_dynamic_energy, baseline.total_dynamic_energy, current.total_dynamic_energy - baseline.total_dynamic_energy);
+    fprintf(statistics_file, "%-28s %12.2f %12.2f %+12.2f\n", "Total energy", current.total_energy, baseline.total_energy, current.total_energy - baseline.total_energy);
+    fprintf(statistics_file, "%-28s %12ld %12ld %+12ld\n", "Frequency calculations", current.num_freq_calculations, baseline.num_freq_calculations, current.num_freq_calculations - baseline.num_freq_calculations);
+    fprintf(statistics_file, "%-28s %12ld %12ld %+12ld\n", "Frequency changes", current.num_freq_changes, baseline.num_freq_changes, current.num_freq_changes - baseline.num_freq_changes);
+    fprintf(statistics_file, "%-28s %12ld %12ld %+12ld\n", "Context-switches", current.num_context_switches, baseline.num_context_switches, current.num_context_switches - baseline.num_context_switches);
+    fprintf(statistics_file, "%-28s %12ld %12ld %+12ld\n", "Preemptions", current.num_preemptions, baseline.num_preemptions, current.num_preemptions - baseline.num_preemptions);
+    fprintf(statistics_file, "%-28s %12.2f %12.2f %+12.2f\n", "Overhead time", current.total_overhead_time, baseline.total_overhead_time, current.total_overhead_time - baseline.total_overhead_time);
+    fprintf(statistics_file, "%-28s %12.2f %12.2f %+12.2f\n", "Overhead energy", current.total_overhead_energy, baseline.total_overhead_energy, current.total_overhead_energy - baseline.total_overhead_energy);
+    fprintf(statistics_file, "%-28s %12ld %12ld %+12ld\n", "Deadline misses", current.num_deadline_misses, baseline.num_deadline_misses, current.num_deadline_misses - baseline.num_deadline_misses);
+    fprintf(statistics_file, "%-28s %12d %12d %+12d\n", "Finished jobs", current.num_finished_jobs, baseline.num_finished_jobs, current.num_finished_jobs - baseline.num_finished_jobs);
+
+    return;
+}
@@ -0,0 +1,20 @@
+typedef struct
+{
+    float total_dynamic_energy;
+    float total_energy; // Dynamic, static, idle, sleep and transition energy.
+    long num_freq_calculations;
+    long num_freq_changes;
+    long num_context_switches;
+    long num_preemptions;
+    float total_overhead_time; // Decision making, frequency calculations and changes, preemptions (and cache reloads).
+    float total_overhead_energy;
+    long num_deadline_misses;
+    int num_finished_jobs;
+}
+Simulation_summary;
+
+// Functions.
+void summarise_simulation(Simulation_summary *); // Captures the results of the simulation that just finished in the current thread.
+void run_baseline_simulation(void (*)(), Simulation_summary *); // Simulates the same task-set (with the same seed) in its own thread with some policies disabled.
+void *simulate_baseline(void *); // Simulates the baseline (runs in its own thread).
+void compare_with_baseline(void (*)(), const char *); // Simulates the baseline and prints the comparison with the simulation that just finished.
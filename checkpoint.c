@@ -0,0 +1,843 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "event_calendar.h"
+#include "aperiodic.h"
+#include "aet_source.h"
+#include "crpd.h"
+#include "slack_reclaiming.h"
+#include "histogram.h"
+#include "segment_index.h"
+#include "checkpoint.h"
+#include "what_if.h"
+
+// Global variables whose values make up the state of the scheduler.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+
+// Tasks, jobs and frequency (and voltage) data.
+extern _Thread_local int num_tasks;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local long end_of_execution_time;
+extern _Thread_local long num_freq_calculations;
+extern _Thread_local long num_freq_changes;
+extern _Thread_local float total_dynamic_energy;
+extern unsigned long long simulation_seed;
+extern _Thread_local unsigned long long random_state;
+
+// Scheduler.
+extern _Thread_local int core_num;
+extern _Thread_local Freq_and_voltage current_freq_and_voltage;
+extern _Thread_local int current_freq_and_voltage_index;
+extern _Thread_local int split_freq_and_voltage_index;
+extern _Thread_local Calendar_event *frequency_switch_event;
+extern _Thread_local long num_split_freq_changes;
+extern _Thread_local long num_held_freq_changes;
+extern _Thread_local Calendar_event *prediction_overrun_event;
+extern _Thread_local Job *ready_queue;
+extern _Thread_local int num_job_in_ready_queue;
+extern _Thread_local int current_job_ready_queue_index;
+extern _Thread_local int current_job_overall_job_index;
+extern _Thread_local float current_time;
+extern _Thread_local long next_deadline;
+extern _Thread_local float next_decision_point;
+extern _Thread_local long num_context_switches;
+extern _Thread_local long num_preemptions;
+extern _Thread_local long num_cache_impact_points;
+extern _Thread_local long num_deadline_misses;
+extern _Thread_local long *task_deadline_misses;
+extern _Thread_local long *task_aborted_jobs;
+extern _Thread_local long *task_skipped_jobs;
+extern _Thread_local int *skip_next_instance;
+extern _Thread_local int simulation_aborted;
+extern _Thread_local int prev_task_instance;
+extern _Thread_local int prev_task;
+extern _Thread_local int current_task_instance;
+extern _Thread_local int current_task;
+extern _Thread_local int prev_return_value;
+extern _Thread_local int event;
+extern _Thread_local Calendar_event *completion_event;
+
+// Aperiodic and sporadic jobs and their server.
+extern _Thread_local Aperiodic_job *aperiodic_jobs;
+extern _Thread_local int num_aperiodic_jobs;
+extern _Thread_local int num_aperiodic_jobs_arrived;
+extern _Thread_local int next_aperiodic_job_to_serve;
+extern _Thread_local float pending_aperiodic_work;
+extern _Thread_local int server_task_num;
+extern _Thread_local int latest_server_job;
+extern _Thread_local int server_active;
+extern _Thread_local float server_budget;
+extern _Thread_local float server_activation_time;
+extern _Thread_local float server_budget_consumed;
+extern _Thread_local float *replenishment_amounts;
+extern _Thread_local int num_replenishments;
+
+// Energy accounting.
+extern _Thread_local float total_static_energy;
+extern _Thread_local float total_idle_energy;
+extern _Thread_local float total_sleep_energy;
+extern _Thread_local float total_transition_energy;
+extern _Thread_local float total_idle_time;
+extern _Thread_local float total_sleep_time;
+extern _Thread_local float total_procrastination_time;
+extern _Thread_local int num_sleeps[NUM_SLEEP_STATES];
+extern _Thread_local float total_overhead_time;
+extern _Thread_local float total_overhead_energy;
+extern _Thread_local float *level_execution_time;
+extern _Thread_local float *level_execution_energy;
+extern _Thread_local float *level_overhead_time;
+extern _Thread_local float *level_overhead_energy;
+extern _Thread_local float *task_level_time;
+extern _Thread_local float *task_level_energy;
+
+// Prediction, execution time models, histograms and the segment index.
+extern _Thread_local float *predicted_execution_times;
+extern _Thread_local float *prediction_errors;
+extern _Thread_local int *num_predictions;
+extern _Thread_local int *num_prediction_overruns;
+extern _Thread_local Aet_source *aet_sources;
+extern _Thread_local int *lru_tasks;
+extern _Thread_local int num_lru_tasks;
+extern _Thread_local float *task_crpd_time;
+extern _Thread_local long *task_num_cache_reloads;
+extern _Thread_local long *task_reloaded_blocks;
+extern _Thread_local Slack_entry *slack_pool;
+extern _Thread_local int num_slack_entries;
+extern _Thread_local int slack_holder_job;
+extern _Thread_local float held_slack;
+extern _Thread_local float total_slack_donated;
+extern _Thread_local float total_slack_reclaimed;
+extern _Thread_local long num_slack_reclaims;
+extern _Thread_local Histogram *task_histograms;
+extern _Thread_local Indexed_segment *segments;
+extern _Thread_local long num_segments;
+
+// Whether the simulation of this thread takes snapshots and resumes from them (the baseline does not).
+_Thread_local int checkpoints_enabled;
+_Thread_local long next_checkpoint_time; // Snapshots are named after the multiple of CHECKPOINT_INTERVAL they are due at.
+_Thread_local int spliced_with_base_run; // Whether the rest of the schedule has been taken from the base run (see what_if.c).
+
+// How transfer_checkpoint_state() goes through the state (see checkpoint.h).
+static _Thread_local int checkpoint_mode;
+static _Thread_local FILE *final_checkpoint_file; // Final snapshot of the base run (when splicing).
+static _Thread_local int state_differs; // Whether the state differs from the snapshot (when comparing).
+
+
+/*
+ * Pre-condition: The initialised scheduler (before it starts scheduling).
+ * Post-condition: If a snapshot is to be restored (or a what-if simulation resumes from one), the scheduler continues from it. The time of the next snapshot is found.
+ */
+void
+init_checkpoints()
+{
+    spliced_with_base_run = 0;
+    if (!checkpoints_enabled)
+        return;
+
+    if (WHAT_IF_TASK >= 0)
+        init_what_if();
+    else if (RESTORE_CHECKPOINT_TIME >= 0)
+    {
+        char file_name[256];
+        find_checkpoint_file_name(file_name, sizeof(file_name), core_num, RESTORE_CHECKPOINT_TIME);
+        if (!restore_checkpoint(file_name))
+            fprintf(output_file, "No snapshot %s (this core took no snapshot at t=%d), so the core is simulated from t=0.\n\n", file_name, RESTORE_CHECKPOINT_TIME);
+    }
+
+    if (CHECKPOINT_INTERVAL > 0)
+        next_checkpoint_time = ((long) (current_time / (float) CHECKPOINT_INTERVAL) + 1) * CHECKPOINT_INTERVAL;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The scheduler at the start of a decision point.
+ * Post-condition: If a multiple of CHECKPOINT_INTERVAL has been reached, a snapshot is taken (one per decision point, named after the last multiple reached).
+ * A what-if simulation instead compares its state with the snapshot of the base run. Returns 1 if the rest of the schedule is that of the base run (so the scheduler can stop).
+ */
+int
+take_due_checkpoint()
+{
+    if (spliced_with_base_run)
+        return 1;
+    if (!checkpoints_enabled || CHECKPOINT_INTERVAL <= 0 || current_time < next_checkpoint_time)
+        return 0;
+
+    long checkpoint_time = (long) (current_time / (float) CHECKPOINT_INTERVAL) * CHECKPOINT_INTERVAL;
+    next_checkpoint_time = checkpoint_time + CHECKPOINT_INTERVAL;
+    if (WHAT_IF_TASK >= 0)
+        return converge_with_base_run(checkpoint_time);
+
+    char file_name[256];
+    find_checkpoint_file_name(file_name, sizeof(file_name), core_num, checkpoint_time);
+    write_checkpoint(file_name);
+
+    return 0;
+}
+
+
+/*
+ * Pre-condition: The scheduler after it has finished scheduling.
+ * Post-condition: The final state is written to the final snapshot (which a what-if simulation takes the rest of its statistics from).
+ */
+void
+write_final_checkpoint()
+{
+    if (!checkpoints_enabled || CHECKPOINT_INTERVAL <= 0 || WHAT_IF_TASK >= 0)
+        return;
+
+    char file_name[256];
+    find_checkpoint_file_name(file_name, sizeof(file_name), core_num, CHECKPOINT_FINAL);
+    write_checkpoint(file_name);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A buffer, the core and the (multiple of CHECKPOINT_INTERVAL) time of the snapshot (CHECKPOINT_FINAL for the final snapshot).
+ * Post-condition: The buffer holds the name of the snapshot (partitioned cores have snapshots of their own).
+ */
+void
+find_checkpoint_file_name(char *file_name, size_t size, int core, long time)
+{
+    char suffix[32];
+    if (time == CHECKPOINT_FINAL)
+        snprintf(suffix, sizeof(suffix), "final");
+    else
+        snprintf(suffix, sizeof(suffix), "t%ld", time);
+
+    if (NUM_CORES > 1)
+        snprintf(file_name, size, "%s_core_%d_%s.bin", CHECKPOINT_FILE_NAME, core, suffix);
+    else
+        snprintf(file_name, size, "%s_%s.bin", CHECKPOINT_FILE_NAME, suffix);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The scheduler at the start of a decision point (or after it has finished), and the name of the snapshot.
+ * Post-condition: The header and the state of every module are written to the snapshot.
+ */
+void
+write_checkpoint(const char *file_name)
+{
+    FILE *file = fopen(file_name, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "ERROR: Could not open the snapshot %s.\n", file_name);
+        exit(0);
+    }
+
+    Checkpoint_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.core_num = core_num;
+    header.num_tasks = num_tasks;
+    header.num_jobs = num_jobs;
+    header.num_freq_levels = num_freq_levels;
+    header.end_of_execution_time = end_of_execution_time;
+    header.seed = simulation_seed + core_num;
+    header.time = current_time;
+    write_checkpoint_data(file, &header, sizeof(header));
+
+    checkpoint_mode = CHECKPOINT_WRITE;
+    transfer_checkpoint_state(file);
+
+    fprintf(output_file, "Snapshot of the scheduler written to %s at t=%0.2f (%ld bytes).\n", file_name, current_time, ftell(file));
+    fclose(file);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The name of a snapshot and a header.
+ * Post-condition: Opens the snapshot and reads its header (which has to be of the task-set being simulated). Returns NULL if there is no such snapshot.
+ */
+FILE *
+open_checkpoint(const char *file_name, Checkpoint_header *header)
+{
+    FILE *file = fopen(file_name, "rb");
+    if (!file)
+        return NULL;
+
+    read_checkpoint_data(file, header, sizeof(Checkpoint_header));
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0)
+    {
+        fprintf(stderr, "ERROR: %s is not a snapshot of the scheduler.\n", file_name);
+        exit(0);
+    }
+    if (header->core_num != core_num || header->num_tasks != num_tasks || header->num_jobs != num_jobs || header->num_freq_levels != num_freq_levels || header->end_of_execution_time != end_of_execution_time)
+    {
+        fprintf(stderr, "ERROR: The snapshot %s was taken with another task-set, set of frequencies or core.\n", file_name);
+        exit(0);
+    }
+
+    return file;
+}
+
+
+/*
+ * Pre-condition: The initialised scheduler of the same task-set (and configuration) as the snapshot, and the name of the snapshot.
+ * Post-condition: The state of every module is that of the snapshot, so the scheduler continues exactly as the simulation that took it. Returns 0 (with the state untouched) if there is no such snapshot.
+ *
+ * A core without a snapshot at that time either finished before it or had no decision point till the next multiple of CHECKPOINT_INTERVAL, so simulating it from t=0 gives the same results.
+ */
+int
+restore_checkpoint(const char *file_name)
+{
+    Checkpoint_header header;
+    FILE *file = open_checkpoint(file_name, &header);
+    if (!file)
+        return 0;
+
+    checkpoint_mode = CHECKPOINT_READ;
+    transfer_checkpoint_state(file);
+    fclose(file);
+
+    fprintf(output_file, "Scheduler resumed from the snapshot %s at t=%0.2f.\n\n", file_name, current_time);
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: The scheduler at the start of a decision point, and the name of a snapshot taken at the same time.
+ * Post-condition: Returns 1 if the scheduler would continue exactly as the simulation that took the snapshot (its statistics so far can differ), 0 otherwise (or if there is no such snapshot).
+ */
+int
+compare_checkpoint(const char *file_name)
+{
+    Checkpoint_header header;
+    FILE *file = open_checkpoint(file_name, &header);
+    if (!file)
+        return 0;
+
+    state_differs = (header.time != current_time);
+    checkpoint_mode = CHECKPOINT_COMPARE;
+    if (!state_differs)
+        transfer_checkpoint_state(file);
+    fclose(file);
+
+    return !state_differs;
+}
+
+
+/*
+ * Pre-condition: A state that compare_checkpoint() found to be the same as that of a snapshot of the base run, the name of the snapshot and the name of the final snapshot of the base run.
+ * Post-condition: The state is that at the end of the base run, with everything the base run did after the snapshot added to the statistics.
+ */
+void
+splice_checkpoint(const char *file_name, const char *final_file_name)
+{
+    Checkpoint_header header, final_header;
+    FILE *file = open_checkpoint(file_name, &header);
+    final_checkpoint_file = open_checkpoint(final_file_name, &final_header);
+    if (!file || !final_checkpoint_file)
+    {
+        fprintf(stderr, "ERROR: Could not open the snapshots %s and %s of the base run.\n", file_name, final_file_name);
+        exit(0);
+    }
+
+    checkpoint_mode = CHECKPOINT_SPLICE;
+    transfer_checkpoint_state(file);
+    fclose(file);
+    fclose(final_checkpoint_file);
+    final_checkpoint_file = NULL;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A snapshot after the data is written (or at the data being read), and the data.
+ * Post-condition: Transfers data that is part of the state of the schedule.
+ * It is written (or read back), compared with the snapshot, or replaced by that of the final snapshot when splicing.
+ */
+static void
+transfer_state(FILE *file, void *data, size_t size)
+{
+    if (size == 0) // An empty array (whose pointer can be NULL).
+        return;
+
+    if (checkpoint_mode == CHECKPOINT_WRITE)
+        write_checkpoint_data(file, data, size);
+    else if (checkpoint_mode == CHECKPOINT_READ)
+        read_checkpoint_data(file, data, size);
+    else if (checkpoint_mode == CHECKPOINT_COMPARE && !state_differs)
+    {
+        char *saved = (char *) malloc(size + 1);
+        read_checkpoint_data(file, saved, size);
+        state_differs = (memcmp(saved, data, size) != 0);
+        free(saved);
+    }
+    else if (checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        fseek(file, size, SEEK_CUR);
+        read_checkpoint_data(final_checkpoint_file, data, size);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A snapshot, and the number of the statistics and their size.
+ * Post-condition: Returns 1 if the statistics are to be written or read like the rest of the state. Otherwise the statistics are skipped (when comparing) or the two copies from the snapshots are read (when splicing).
+ */
+static int
+transfer_statistics(FILE *file, void *base, void *final, size_t size)
+{
+    if (checkpoint_mode == CHECKPOINT_WRITE || checkpoint_mode == CHECKPOINT_READ)
+        return 1;
+
+    if (checkpoint_mode == CHECKPOINT_COMPARE)
+    {
+        if (!state_differs)
+            fseek(file, size, SEEK_CUR);
+    }
+    else
+    {
+        read_checkpoint_data(file, base, size);
+        read_checkpoint_data(final_checkpoint_file, final, size);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Pre-condition: A snapshot and counters (or sums) that only add up over the schedule.
+ * Post-condition: Transfers the counters. When splicing, what the base run added after the snapshot is added to them. (A counter that is the same as in the snapshot simply takes the final value, so that it stays exact).
+ */
+static void
+transfer_floats(FILE *file, float *data, int num)
+{
+    float *base = (float *) malloc(sizeof(float) * (num + 1));
+    float *final = (float *) malloc(sizeof(float) * (num + 1));
+    if (transfer_statistics(file, base, final, sizeof(float) * num))
+        transfer_state(file, data, sizeof(float) * num);
+    else if (checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        for (int i = 0; i < num; i++)
+            data[i] = (data[i] == base[i]) ? final[i] : data[i] + (final[i] - base[i]);
+    }
+    free(base);
+    free(final);
+
+    return;
+}
+
+
+static void
+transfer_longs(FILE *file, long *data, int num)
+{
+    long *base = (long *) malloc(sizeof(long) * (num + 1));
+    long *final = (long *) malloc(sizeof(long) * (num + 1));
+    if (transfer_statistics(file, base, final, sizeof(long) * num))
+        transfer_state(file, data, sizeof(long) * num);
+    else if (checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        for (int i = 0; i < num; i++)
+            data[i] += final[i] - base[i];
+    }
+    free(base);
+    free(final);
+
+    return;
+}
+
+
+static void
+transfer_ints(FILE *file, int *data, int num)
+{
+    int *base = (int *) malloc(sizeof(int) * (num + 1));
+    int *final = (int *) malloc(sizeof(int) * (num + 1));
+    if (transfer_statistics(file, base, final, sizeof(int) * num))
+        transfer_state(file, data, sizeof(int) * num);
+    else if (checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        for (int i = 0; i < num; i++)
+            data[i] += final[i] - base[i];
+    }
+    free(base);
+    free(final);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A snapshot and an array of the state whose length changes over the schedule (along with its length).
+ * Post-condition: Transfers the length and the array (which is resized when it is read).
+ */
+static void
+transfer_state_array(FILE *file, void **array, int *num, size_t element_size)
+{
+    if (checkpoint_mode == CHECKPOINT_COMPARE)
+    {
+        transfer_state(file, num, sizeof(int));
+        if (!state_differs)
+            transfer_state(file, *array, element_size * *num);
+        return;
+    }
+
+    if (checkpoint_mode == CHECKPOINT_SPLICE) // The array of the snapshot is skipped.
+    {
+        int num_saved;
+        read_checkpoint_data(file, &num_saved, sizeof(num_saved));
+        fseek(file, element_size * num_saved, SEEK_CUR);
+        read_checkpoint_data(final_checkpoint_file, num, sizeof(int));
+        *array = realloc(*array, element_size * (*num + 1));
+        read_checkpoint_data(final_checkpoint_file, *array, element_size * *num);
+        return;
+    }
+
+    transfer_state(file, num, sizeof(int));
+    if (checkpoint_mode == CHECKPOINT_READ)
+        *array = realloc(*array, element_size * (*num + 1));
+    transfer_state(file, *array, element_size * *num);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A snapshot, an array of records (such as jobs) and a function that tells whether a record is finished.
+ * Post-condition: Transfers the records. The finished records are history, so only the unfinished ones have to be the same when comparing.
+ * When splicing, a record that is the same as in the snapshot takes its final value (a record that differs has already finished).
+ */
+static void
+transfer_records(FILE *file, void *records, int num, size_t size, int (*finished)(const void *))
+{
+    char *base = (char *) malloc(size * num + 1);
+    char *final = (char *) malloc(size * num + 1);
+    char *data = (char *) records;
+
+    if (checkpoint_mode == CHECKPOINT_WRITE || checkpoint_mode == CHECKPOINT_READ)
+        transfer_state(file, records, size * num);
+    else if (checkpoint_mode == CHECKPOINT_COMPARE && !state_differs)
+    {
+        read_checkpoint_data(file, base, size * num);
+        for (int i = 0; i < num && !state_differs; i++)
+        {
+            if ((!finished(data + i * size) || !finished(base + i * size)) && memcmp(data + i * size, base + i * size, size) != 0)
+                state_differs = 1;
+        }
+    }
+    else if (checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        read_checkpoint_data(file, base, size * num);
+        read_checkpoint_data(final_checkpoint_file, final, size * num);
+        for (int i = 0; i < num; i++)
+        {
+            if (memcmp(data + i * size, base + i * size, size) == 0)
+                memcpy(data + i * size, final + i * size, size);
+        }
+    }
+
+    free(base);
+    free(final);
+
+    return;
+}
+
+
+static int
+job_finished(const void *job)
+{
+    return ((const Job *) job)->alive == false;
+}
+
+
+static int
+aperiodic_job_finished(const void *job)
+{
+    return ((const Aperiodic_job *) job)->finish_time >= 0;
+}
+
+
+/*
+ * Pre-condition: A snapshot and the histograms of the tasks.
+ * Post-condition: Transfers the histograms. When splicing, the values the base run added after the snapshot are added (its extremes are only taken if they were reached after the snapshot).
+ */
+static void
+transfer_histograms(FILE *file, Histogram *histograms, int num)
+{
+    Histogram *base = (Histogram *) malloc(sizeof(Histogram) * num);
+    Histogram *final = (Histogram *) malloc(sizeof(Histogram) * num);
+    if (transfer_statistics(file, base, final, sizeof(Histogram) * num))
+        transfer_state(file, histograms, sizeof(Histogram) * num);
+    else if (checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        for (int i = 0; i < num; i++)
+        {
+            for (int j = 0; j < HISTOGRAM_NUM_BUCKETS; j++)
+                histograms[i].counts[j] += final[i].counts[j] - base[i].counts[j];
+            histograms[i].num_values += final[i].num_values - base[i].num_values;
+            histograms[i].sum = (histograms[i].sum == base[i].sum) ? final[i].sum : histograms[i].sum + (final[i].sum - base[i].sum);
+            if (final[i].min < base[i].min && final[i].min < histograms[i].min)
+                histograms[i].min = final[i].min;
+            if (final[i].max > base[i].max && final[i].max > histograms[i].max)
+                histograms[i].max = final[i].max;
+        }
+    }
+    free(base);
+    free(final);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A snapshot after its header, and the mode of the transfer in checkpoint_mode.
+ * Post-condition: The state of every module is written to the snapshot, read back from it, compared with it or spliced with the base run. All the modes go through the same sequence, so they cannot drift apart.
+ *
+ * The state of the schedule has to be the same for a what-if simulation to converge with the base run, while the statistics only add up (so they are not compared).
+ * The calendar events that the scheduler refers to are written as their sequence numbers, and found again once the event calendar is restored.
+ * The run-time flags of the policies are not part of the state, so a snapshot can be resumed with other policies to fork a "what if" schedule.
+ */
+void
+transfer_checkpoint_state(FILE *file)
+{
+    // Psuedo-random numbers and the scheduler.
+    transfer_state(file, &random_state, sizeof(random_state));
+    transfer_state(file, &current_time, sizeof(current_time));
+    transfer_state(file, &next_deadline, sizeof(next_deadline));
+    transfer_state(file, &next_decision_point, sizeof(next_decision_point));
+    transfer_state(file, &current_freq_and_voltage, sizeof(current_freq_and_voltage));
+    transfer_state(file, &current_freq_and_voltage_index, sizeof(current_freq_and_voltage_index));
+    transfer_state(file, &split_freq_and_voltage_index, sizeof(split_freq_and_voltage_index));
+    transfer_state(file, &current_job_ready_queue_index, sizeof(current_job_ready_queue_index));
+    transfer_state(file, &current_job_overall_job_index, sizeof(current_job_overall_job_index));
+    transfer_state(file, &prev_task_instance, sizeof(prev_task_instance));
+    transfer_state(file, &prev_task, sizeof(prev_task));
+    transfer_state(file, &current_task_instance, sizeof(current_task_instance));
+    transfer_state(file, &current_task, sizeof(current_task));
+    transfer_state(file, &prev_return_value, sizeof(prev_return_value));
+    transfer_state(file, &event, sizeof(event));
+    transfer_state(file, &simulation_aborted, sizeof(simulation_aborted));
+    transfer_state(file, skip_next_instance, sizeof(int) * num_tasks);
+
+    // Statistics of the scheduler.
+    transfer_longs(file, &num_freq_calculations, 1);
+    transfer_longs(file, &num_freq_changes, 1);
+    transfer_longs(file, &num_split_freq_changes, 1);
+    transfer_longs(file, &num_held_freq_changes, 1);
+    transfer_floats(file, &total_dynamic_energy, 1);
+    transfer_longs(file, &num_context_switches, 1);
+    transfer_longs(file, &num_preemptions, 1);
+    transfer_longs(file, &num_cache_impact_points, 1);
+    transfer_longs(file, &num_deadline_misses, 1);
+    transfer_longs(file, task_deadline_misses, num_tasks);
+    transfer_longs(file, task_aborted_jobs, num_tasks);
+    transfer_longs(file, task_skipped_jobs, num_tasks);
+
+    // Jobs and the ready queue.
+    transfer_records(file, jobs, num_jobs, sizeof(Job), job_finished);
+    transfer_state_array(file, (void **) &ready_queue, &num_job_in_ready_queue, sizeof(Job));
+
+    // Event calendar, along with the events that the scheduler refers to. (The sequence numbers of two simulations differ, so only the order of the events is compared.)
+    Calendar_event **scheduler_events[] = {&completion_event, &frequency_switch_event, &prediction_overrun_event};
+    unsigned long event_sequences[3];
+    for (int i = 0; i < 3; i++)
+    {
+        event_sequences[i] = (*scheduler_events[i]) ? (*scheduler_events[i])->sequence : ULONG_MAX;
+        if (checkpoint_mode == CHECKPOINT_COMPARE)
+            fseek(file, sizeof(event_sequences[i]), SEEK_CUR);
+        else
+            transfer_state(file, &event_sequences[i], sizeof(event_sequences[i]));
+    }
+    if (checkpoint_mode == CHECKPOINT_WRITE)
+        save_event_calendar(file);
+    else if (checkpoint_mode == CHECKPOINT_COMPARE && !state_differs)
+        state_differs = !compare_event_calendar(file);
+    else if (checkpoint_mode == CHECKPOINT_READ || checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        if (checkpoint_mode == CHECKPOINT_SPLICE)
+            compare_event_calendar(file); // Only skips the events of the snapshot.
+        restore_event_calendar((checkpoint_mode == CHECKPOINT_SPLICE) ? final_checkpoint_file : file);
+        for (int i = 0; i < 3; i++)
+            *scheduler_events[i] = (event_sequences[i] != ULONG_MAX) ? find_calendar_event(event_sequences[i]) : NULL;
+    }
+    if (checkpoint_mode == CHECKPOINT_COMPARE && state_differs)
+        return;
+
+    // Aperiodic and sporadic jobs and their server.
+    int num_aperiodic_jobs_saved = num_aperiodic_jobs;
+    transfer_state(file, &num_aperiodic_jobs_saved, sizeof(num_aperiodic_jobs_saved));
+    if (num_aperiodic_jobs_saved != num_aperiodic_jobs)
+    {
+        fprintf(stderr, "ERROR: The snapshot was taken with another stream of aperiodic jobs.\n");
+        exit(0);
+    }
+    transfer_records(file, aperiodic_jobs, num_aperiodic_jobs, sizeof(Aperiodic_job), aperiodic_job_finished);
+    transfer_state(file, &num_aperiodic_jobs_arrived, sizeof(num_aperiodic_jobs_arrived));
+    transfer_state(file, &next_aperiodic_job_to_serve, sizeof(next_aperiodic_job_to_serve));
+    transfer_state(file, &pending_aperiodic_work, sizeof(pending_aperiodic_work));
+    transfer_state(file, &server_task_num, sizeof(server_task_num));
+    transfer_state(file, &latest_server_job, sizeof(latest_server_job));
+    transfer_state(file, &server_active, sizeof(server_active));
+    transfer_state(file, &server_budget, sizeof(server_budget));
+    transfer_state(file, &server_activation_time, sizeof(server_activation_time));
+    transfer_state(file, &server_budget_consumed, sizeof(server_budget_consumed));
+    transfer_state_array(file, (void **) &replenishment_amounts, &num_replenishments, sizeof(float));
+
+    // Energy accounting.
+    transfer_floats(file, &total_static_energy, 1);
+    transfer_floats(file, &total_idle_energy, 1);
+    transfer_floats(file, &total_sleep_energy, 1);
+    transfer_floats(file, &total_transition_energy, 1);
+    transfer_floats(file, &total_idle_time, 1);
+    transfer_floats(file, &total_sleep_time, 1);
+    transfer_floats(file, &total_procrastination_time, 1);
+    transfer_ints(file, num_sleeps, NUM_SLEEP_STATES);
+    transfer_floats(file, &total_overhead_time, 1);
+    transfer_floats(file, &total_overhead_energy, 1);
+    transfer_floats(file, level_execution_time, num_freq_levels);
+    transfer_floats(file, level_execution_energy, num_freq_levels);
+    transfer_floats(file, level_overhead_time, num_freq_levels);
+    transfer_floats(file, level_overhead_energy, num_freq_levels);
+    transfer_floats(file, task_level_time, num_tasks * num_freq_levels);
+    transfer_floats(file, task_level_energy, num_tasks * num_freq_levels);
+
+    // Prediction of the execution times.
+    transfer_state(file, predicted_execution_times, sizeof(float) * num_tasks);
+    transfer_floats(file, prediction_errors, num_tasks);
+    transfer_ints(file, num_predictions, num_tasks);
+    transfer_ints(file, num_prediction_overruns, num_tasks);
+
+    // Models of the execution times (the traces continue from the same position).
+    for (int i = 0; i < num_tasks; i++)
+    {
+        transfer_state(file, &aet_sources[i].state, sizeof(aet_sources[i].state));
+        transfer_state(file, &aet_sources[i].trace.pos, sizeof(aet_sources[i].trace.pos));
+        transfer_state(file, &aet_sources[i].trace.line, sizeof(aet_sources[i].trace.line));
+        transfer_longs(file, &aet_sources[i].num_trace_values, 1);
+        transfer_longs(file, &aet_sources[i].num_clamped, 1);
+    }
+
+    // Cache of the CRPD model (which tasks still have blocks in it) and the delay of every task.
+    transfer_state(file, &num_lru_tasks, sizeof(num_lru_tasks));
+    transfer_state(file, lru_tasks, sizeof(int) * num_tasks);
+    transfer_floats(file, task_crpd_time, num_tasks);
+    transfer_longs(file, task_num_cache_reloads, num_tasks);
+    transfer_longs(file, task_reloaded_blocks, num_tasks);
+
+    // Slack pool of the jobs that finished early, and the slack held by the running job.
+    transfer_state_array(file, (void **) &slack_pool, &num_slack_entries, sizeof(Slack_entry));
+    transfer_state(file, &slack_holder_job, sizeof(slack_holder_job));
+    transfer_state(file, &held_slack, sizeof(held_slack));
+    transfer_floats(file, &total_slack_donated, 1);
+    transfer_floats(file, &total_slack_reclaimed, 1);
+    transfer_longs(file, &num_slack_reclaims, 1);
+
+    // Histograms of the tasks.
+    transfer_histograms(file, task_histograms, num_tasks * NUM_TASK_HISTOGRAMS);
+
+    // Segment index (its prefix sums and block summaries are rebuilt from the segments). When splicing, the segments of the base run after the snapshot are appended.
+    long num_segments_saved = (segments) ? num_segments : 0;
+    if (checkpoint_mode == CHECKPOINT_WRITE)
+    {
+        write_checkpoint_data(file, &num_segments_saved, sizeof(num_segments_saved));
+        write_checkpoint_data(file, segments, sizeof(Indexed_segment) * num_segments_saved);
+    }
+    else if (checkpoint_mode == CHECKPOINT_READ || checkpoint_mode == CHECKPOINT_SPLICE)
+    {
+        FILE *segments_file = (checkpoint_mode == CHECKPOINT_SPLICE) ? final_checkpoint_file : file;
+        long first_segment = 0;
+        if (checkpoint_mode == CHECKPOINT_SPLICE)
+            read_checkpoint_data(file, &first_segment, sizeof(first_segment));
+        read_checkpoint_data(segments_file, &num_segments_saved, sizeof(num_segments_saved));
+        fseek(segments_file, sizeof(Indexed_segment) * first_segment, SEEK_CUR);
+
+        Indexed_segment segment;
+        for (long i = first_segment; i < num_segments_saved; i++)
+        {
+            read_checkpoint_data(segments_file, &segment, sizeof(segment));
+            add_indexed_segment(segment.sorted_task_num, segment.instance_num, segment.level, segment.start, segment.end);
+        }
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: None. (Called before the scheduler starts when a snapshot is to be restored).
+ * Post-condition: Returns the seed of the simulation that took the snapshots (from the first core that has one), so that the resumed (or what-if) simulation uses the same seed.
+ */
+unsigned long long
+find_checkpoint_seed()
+{
+    long time = (WHAT_IF_TASK >= 0) ? CHECKPOINT_FINAL : RESTORE_CHECKPOINT_TIME;
+    char file_name[256];
+    for (int i = 0; i < NUM_CORES; i++)
+    {
+        find_checkpoint_file_name(file_name, sizeof(file_name), i, time);
+        FILE *file = fopen(file_name, "rb");
+        if (!file)
+            continue;
+
+        Checkpoint_header header;
+        read_checkpoint_data(file, &header, sizeof(header));
+        fclose(file);
+        if (memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0)
+        {
+            fprintf(stderr, "ERROR: %s is not a snapshot of the scheduler.\n", file_name);
+            exit(0);
+        }
+
+        return header.seed - header.core_num;
+    }
+
+    fprintf(stderr, "ERROR: There is no snapshot to resume from (%s).\n", file_name);
+    exit(0);
+}
+
+
+/*
+ * Pre-condition: A snapshot open for writing, and the data.
+ * Post-condition: The data is written to the snapshot.
+ */
+void
+write_checkpoint_data(FILE *file, const void *data, size_t size)
+{
+    if (size > 0 && fwrite(data, size, 1, file) != 1)
+    {
+        fprintf(stderr, "ERROR: Could not write the snapshot.\n");
+        exit(0);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A snapshot open for reading, and a buffer for the data.
+ * Post-condition: The data is read from the snapshot (the program exits if the snapshot is cut short).
+ */
+void
+read_checkpoint_data(FILE *file, void *data, size_t size)
+{
+    if (size > 0 && fread(data, size, 1, file) != 1)
+    {
+        fprintf(stderr, "ERROR: The snapshot is incomplete.\n");
+        exit(0);
+    }
+
+    return;
+}
@@ -0,0 +1,37 @@
+#define CHECKPOINT_MAGIC "CCRMCP2"
+#define CHECKPOINT_FINAL -1 // Time of the final snapshot (taken once the scheduler has finished).
+
+// Modes of transfer_checkpoint_state().
+#define CHECKPOINT_WRITE 0 // Writes the state to a snapshot.
+#define CHECKPOINT_READ 1 // Replaces the state with that of a snapshot.
+#define CHECKPOINT_COMPARE 2 // Checks whether the schedule would continue as in a snapshot.
+#define CHECKPOINT_SPLICE 3 // Adds what the base run did from a snapshot till its final snapshot.
+
+// Header of a snapshot. The state of the modules follows it in the order of transfer_checkpoint_state().
+typedef struct
+{
+    char magic[8];
+    int core_num;
+    int num_tasks;
+    int num_jobs;
+    int num_freq_levels;
+    long end_of_execution_time;
+    unsigned long long seed;
+    float time; // Time of the decision point at which the snapshot was taken.
+}
+Checkpoint_header;
+
+// Functions.
+void init_checkpoints(); // Resumes from the snapshot of RESTORE_CHECKPOINT_TIME (or the what-if snapshot), if any, and finds when the next snapshot is due.
+int take_due_checkpoint(); // Takes a snapshot if one is due at the current decision point (returns 1 if the rest of the schedule is that of the base run).
+void write_final_checkpoint(); // Writes the state of the finished scheduler to the final snapshot.
+void find_checkpoint_file_name(char *, size_t, int, long); // The name of the snapshot of a core at the given time.
+void write_checkpoint(const char *); // Writes the whole state of the scheduler to a snapshot.
+FILE *open_checkpoint(const char *, Checkpoint_header *); // Opens a snapshot of the task-set and reads its header.
+int restore_checkpoint(const char *); // Replaces the state of the scheduler with that of a snapshot (if there is one).
+int compare_checkpoint(const char *); // Checks whether the scheduler would continue as in a snapshot taken at the same time.
+void splice_checkpoint(const char *, const char *); // Takes the rest of the schedule from the base run.
+void transfer_checkpoint_state(FILE *); // Writes, reads, compares or splices the state of every module.
+unsigned long long find_checkpoint_seed(); // The seed of the simulation that took the snapshot to be restored.
+void write_checkpoint_data(FILE *, const void *, size_t); // Writes raw data to a snapshot.
+void read_checkpoint_data(FILE *, void *, size_t); // Reads raw data from a snapshot.
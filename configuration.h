@@ -3,6 +3,9 @@
 #define INPUT_FREQ_FILE_NAME "input_freq_file.txt"
 #define OUTPUT_FILE_NAME "output_file.txt"
 #define OUTPUT_STATISTICS_FILE_NAME "output_statistics_file.txt"
+#define OUTPUT_BASELINE_FILE_NAME "output_file_baseline.txt" // Schedule of the baseline that the policies being evaluated are compared against.
+#define OUTPUT_BASELINE_STATISTICS_FILE_NAME "output_statistics_file_baseline.txt"
+#define OUTPUT_JSON_FILE_NAME "output_statistics_file.json" // Machine-readable statistics (summary of the simulation and the histograms of the tasks).
 
 // Overhead times.
 #define PREEMPTION_OVERHEAD 0.2
@@ -10,5 +13,138 @@
 #define FREQUENCY_CALCULATION_OVERHEAD 0.05
 #define FREQUENCY_CHANGE_OVERHEAD 0.1
 
+// Model of the decision making and frequency calculation overheads of a decision point (the cost of the CC-RM loop grows with the jobs it walks).
+#define OVERHEAD_CONSTANT 0 // The overheads above.
+#define OVERHEAD_LINEAR 1 // The overheads above along with a term per ready job (and per frequency level for the frequency calculation).
+#define OVERHEAD_TABLE 2 // Measured on the target for some numbers of ready jobs (interpolated in between).
+#define OVERHEAD_MODEL OVERHEAD_CONSTANT
+#define DECISION_MAKING_OVERHEAD_PER_JOB 0.01
+#define FREQUENCY_CALCULATION_OVERHEAD_PER_JOB 0.005
+#define FREQUENCY_CALCULATION_OVERHEAD_PER_LEVEL 0.005
+#define INPUT_OVERHEAD_FILE_NAME "input_overhead_file.txt"
+#define SCHEDULABILITY_WITH_OVERHEADS 0 // 1 = the schedulability tests (static frequency and partitioning) charge every job with the worst-case overheads the scheduler can charge it: a decision point at its release and one at its completion (each with every task ready and the slowest frequency change of the frequency file), and a preemption.
+#define OVERHEAD_AWARE_STATIC_FREQUENCY 0 // 1 = the static frequency is the lowest level at which every task meets its deadline under response-time analysis (instead of rm_test()) with every job charged the overheads of SCHEDULABILITY_WITH_OVERHEADS (whether or not that flag is set, which still decides the partitioning tests), and the slack margin of every task at that level is printed.
+
+// Cache-related preemption delay. With CRPD_MODEL, a task that starts running at a cache impact point reloads its useful blocks that were evicted (LRU) since it last ran, instead of only the flat PREEMPTION_OVERHEAD.
+#define CRPD_MODEL 0
+#define INPUT_CRPD_FILE_NAME "input_crpd_file.txt"
+#define CACHE_SIZE_BLOCKS 256
+#define BLOCK_RELOAD_TIME 0.001 // Time taken to reload one block (unless the input file gives one for the task).
+
 // Minimum percent of execution relative to WCET of a job.
 #define MIN_PERCENT_EXECUTION 50
+
+
+// Binary task-set cache (sorted tasks, frequencies and precomputed metadata keyed by a hash of the inputs).
+#define USE_TASKSET_CACHE 0 // 1 = runs load the cache of their inputs (and write it if there is none yet). "--convert" writes it regardless.
+#define TASKSET_CACHE_FILE_PREFIX "taskset_cache_"
+
+
+// Resolution of the timing wheel of the event calendar (ticks per unit of time). Events closer than one tick are still ordered exactly.
+#define CALENDAR_TICKS_PER_TIME_UNIT 100
+
+
+// Seed of the psuedo-random numbers used for the actual execution times (0 = seed from the current time).
+#define RANDOM_SEED 0
+
+// Multicore (partitioned) scheduling. With more than one core, tasks are partitioned across the cores and every core is simulated in its own thread with its own frequency domain.
+#define NUM_CORES 1
+#define FIRST_FIT_DECREASING 0
+#define BEST_FIT_DECREASING 1
+#define WORST_FIT_DECREASING 2
+#define PARTITIONING_HEURISTIC FIRST_FIT_DECREASING
+#define PARTITIONING_USES_RTA 0 // 1 = response-time analysis per core, 0 = rm_test() per core.
+
+// Global multicore scheduling. With more than one core and GLOBAL_SCHEDULING = 1, all the cores share one ready queue instead of partitioning the tasks.
+#define GLOBAL_SCHEDULING 0
+#define RM_PRIORITY 0
+#define EDF_PRIORITY 1
+#define GLOBAL_PRIORITY_POLICY RM_PRIORITY
+#define CLUSTER_WIDE_DVFS 1 // 1 = all the cores share one frequency level, 0 = every core selects its own level.
+
+// Aperiodic and sporadic jobs, served by a server task that is scheduled like a periodic task (only on one core).
+#define NO_SERVER 0
+#define POLLING_SERVER 1
+#define DEFERRABLE_SERVER 2
+#define SPORADIC_SERVER 3
+#define APERIODIC_SERVER NO_SERVER
+#define SERVER_PERIOD 5
+#define SERVER_BUDGET 1.0
+
+// Arrival stream of the aperiodic and sporadic jobs. Either read from a file or generated.
+#define INPUT_APERIODIC_FILE_NAME "input_aperiodic_file.txt"
+#define APERIODIC_ARRIVALS_FROM_FILE 0
+#define POISSON_ARRIVALS 0 // Aperiodic jobs (no deadlines) with exponentially distributed inter-arrival times.
+#define MIN_INTERARRIVAL_ARRIVALS 1 // Sporadic jobs (with deadlines) that are at least SPORADIC_MIN_INTERARRIVAL apart.
+#define APERIODIC_ARRIVAL_MODEL POISSON_ARRIVALS
+#define APERIODIC_MEAN_INTERARRIVAL 6.0
+#define SPORADIC_MIN_INTERARRIVAL 4.0
+#define SPORADIC_RELATIVE_DEADLINE 10
+#define APERIODIC_MAX_EXECUTION 1.0 // Generated jobs execute for (MIN_PERCENT_EXECUTION to 100)% of this.
+
+// Dynamic power management. Static (leakage) power is consumed while the core is active, idle power while it idles at the lowest frequency and voltage.
+#define STATIC_POWER 0.5 // Used for the levels whose static power is not given in the frequency input file.
+#define IDLE_POWER 1.0
+#define DYNAMIC_POWER_MANAGEMENT 0 // 1 = idle intervals long enough are spent in the deepest sleep state that pays for itself.
+#define NUM_SLEEP_STATES 2
+#define SLEEP_STATES {{0.2, 0.1, 0.5}, {0.05, 0.5, 2.0}} // {Power, wake-up latency, break-even time} of every sleep state (break-even time >= wake-up latency).
+#define DYNAMIC_PROCRASTINATION 0 // 1 = job releases after an idle interval are procrastinated (by at most the RM slack of the tasks) so that idle intervals get longer.
+
+// Two-level frequency splitting. 1 = every allocation window runs at the two levels around the required speed instead of the next higher level.
+#define FREQUENCY_SPLITTING 0
+
+// Prediction of execution times. 1 = every periodic job is budgeted for the EWMA of the actual execution times of its task instead of its remaining time, falling back to its wcet if it overruns the prediction.
+#define AET_PREDICTION 0
+#define AET_PREDICTION_WEIGHT 0.5 // Weight of the latest actual execution time in the EWMA.
+#define PREDICTION_EPSILON 0.0001
+
+// Preemption-threshold RM. 1 = every task gets the highest preemption threshold that keeps the task-set schedulable under response-time analysis, and a started job can only be preempted by tasks of higher priority than its threshold.
+#define PREEMPTION_THRESHOLD 0
+
+// Slack reclaiming. 1 = the time that a finished job was budgeted for but did not use (wcet - aet) is kept till its deadline, and the job that runs next reclaims the slack of the jobs of the same or higher priority to run at a lower frequency.
+#define SLACK_RECLAIMING 0
+
+// Frequency-change hysteresis. 1 = a frequency calculation that picks a lower level only changes the level if the energy saved till the core idles (or likely comes back up at the next release) pays for the change, and otherwise keeps the current level. A higher level is always taken at once, so that the work fits.
+#define FREQUENCY_HYSTERESIS 0
+#define FREQUENCY_HYSTERESIS_BAND 0.1 // The core is likely to come back up at the next release if the dynamic utilisation is then above the lower level by more than the band (the change back up is charged as well).
+
+// Overrun policy of a job that misses its deadline.
+#define OVERRUN_CONTINUE 0 // The job keeps running till it finishes.
+#define OVERRUN_ABORT_JOB 1 // The job is aborted at its deadline.
+#define OVERRUN_SKIP_NEXT 2 // The job keeps running, but the next job of its task is skipped.
+#define OVERRUN_POLICY OVERRUN_CONTINUE
+#define EARLY_ABORT_ON_MISS 0 // 1 = the simulation stops at its first deadline miss (so that infeasible configurations in a sweep cost almost nothing).
+
+// Models of the actual execution times. 1 = the model of every task given in the input file (uniform, beta, bimodal, Markov-modulated or a trace of measured execution times) is used instead of the default (MIN_PERCENT_EXECUTION to 100)% of the wcet.
+#define INPUT_AET_FILE_NAME "input_aet_file.txt"
+#define AET_MODELS_FROM_FILE 0
+
+// Export of the schedule as a Chrome trace-event file (opens in Perfetto or chrome://tracing). Partitioned cores write output_trace_core_i.json instead.
+#define TRACE_EXPORT 0
+#define OUTPUT_TRACE_FILE_NAME "output_trace.json"
+#define TRACE_TIME_SCALE 1000 // Microseconds of the trace per unit of time (so a unit of time is shown as 1 ms).
+#define TRACE_BUFFER_SIZE (1 << 20) // The trace (and the schedule log) is written out in blocks of this many bytes.
+
+// Compact binary log of the schedule (job releases, segments and completions, overheads, frequency changes and idle intervals) that the analyser (./analyse) computes the statistics from. Partitioned cores write output_schedule_log_core_i.bin instead.
+#define SCHEDULE_LOG 0
+#define OUTPUT_SCHEDULE_LOG_FILE_NAME "output_schedule_log.bin"
+
+// Index of the executed segments (sorted by time, with prefix sums and block summaries) for window queries of occupancy, energy and frequency residency in logarithmic time.
+#define SEGMENT_INDEX 0
+#define SEGMENT_INDEX_BLOCK 1024 // Segments per block summary (residency queries scan at most one block on either side).
+#define SEGMENT_INDEX_WINDOW 10 // Length of the windows whose occupancy, energy and residency are printed onto the statistics file.
+#define SEGMENT_INDEX_QUERY_START 0 // The segments from the query start to the query end are printed as well (if the end is after the start).
+#define SEGMENT_INDEX_QUERY_END 0
+
+// Snapshots of the whole state of the scheduler, taken at the first decision point after every multiple of CHECKPOINT_INTERVAL (0 = no snapshots) as checkpoint_t<multiple>.bin (checkpoint_core_i_t<multiple>.bin for partitioned cores).
+// With RESTORE_CHECKPOINT_TIME >= 0, the simulation resumes from the snapshot of that multiple instead of from t=0, with the same results. The global scheduler and the baseline are not checkpointed.
+#define CHECKPOINT_INTERVAL 0
+#define CHECKPOINT_FILE_NAME "checkpoint"
+#define RESTORE_CHECKPOINT_TIME -1
+
+// Incremental what-if simulation against a base run that took snapshots (along with its final snapshot, with the same CHECKPOINT_INTERVAL). With WHAT_IF_TASK >= 0, the jobs of that task released from WHAT_IF_START till WHAT_IF_END (0 = the end of execution time) get a wcet of WHAT_IF_WCET.
+// The simulation resumes from the last snapshot before the first changed job, and stops as soon as its state is back on the base run at one of its snapshots (taking the rest of its statistics from the base run).
+#define WHAT_IF_TASK -1
+#define WHAT_IF_WCET 1.0
+#define WHAT_IF_START 0
+#define WHAT_IF_END 0
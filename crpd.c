@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "parser.h"
+#include "energy.h"
+#include "trace.h"
+#include "schedule_log.h"
+#include "crpd.h"
+
+// Global variables required to find the cache-related preemption delay (CRPD).
+
+// Output files.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+
+// Tasks and frequency (and voltage) data.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int current_freq_and_voltage_index;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local float current_time;
+
+// Footprint of every task (sorted based on period).
+_Thread_local Cache_footprint *cache_footprints;
+
+// The tasks whose blocks were last brought into the cache, most recently run first (LRU order).
+_Thread_local int *lru_tasks;
+_Thread_local int num_lru_tasks;
+
+// Statistics of every task.
+_Thread_local float *task_crpd_time;
+_Thread_local long *task_num_cache_reloads;
+_Thread_local long *task_reloaded_blocks;
+
+
+/*
+ * Pre-condition: The sorted task-set.
+ * Post-condition: Tasks have no footprint unless the input file of the footprints gives one, and the cache is empty.
+ */
+void
+init_crpd()
+{
+    cache_footprints = (Cache_footprint *) calloc(num_tasks, sizeof(Cache_footprint));
+    lru_tasks = (int *) malloc(sizeof(int) * (num_tasks + 1));
+    for (int i = 0; i <= num_tasks; i++)
+        lru_tasks[i] = -1;
+    num_lru_tasks = 0;
+    task_crpd_time = (float *) calloc(num_tasks, sizeof(float));
+    task_num_cache_reloads = (long *) calloc(num_tasks, sizeof(long));
+    task_reloaded_blocks = (long *) calloc(num_tasks, sizeof(long));
+
+    if (CRPD_MODEL)
+    {
+        input_cache_footprints();
+        print_cache_footprints();
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An input file with the number of footprints followed by the task number, the footprint, the useful blocks and optionally the reload time of a block (one task per line).
+ * Post-condition: The footprints of the given tasks. Tasks that are not in the task-set (such as those on other cores) are skipped.
+ */
+void
+input_cache_footprints()
+{
+    Input_file input_crpd_file;
+    open_input_file(&input_crpd_file, INPUT_CRPD_FILE_NAME);
+
+    long num_footprints_input;
+    if (!scan_long(&input_crpd_file, &num_footprints_input) || num_footprints_input < 0)
+        parse_error(&input_crpd_file, input_crpd_file.line, "Invalid number of cache footprints");
+
+    for (long i = 0; i < num_footprints_input; i++) // Iterates over all the footprints.
+    {
+        // Every footprint is on its own line.
+        skip_whitespace(&input_crpd_file);
+        int line = input_crpd_file.line;
+
+        long task_num, footprint, useful_blocks;
+        if (!scan_long(&input_crpd_file, &task_num) || !scan_long(&input_crpd_file, &footprint) || !scan_long(&input_crpd_file, &useful_blocks))
+            parse_error(&input_crpd_file, line, "Expected the task number, the footprint and the useful blocks of a task");
+
+        float block_reload_time = BLOCK_RELOAD_TIME;
+        if (input_crpd_file.line == line && !end_of_line(&input_crpd_file) && !scan_float(&input_crpd_file, &block_reload_time))
+            parse_error(&input_crpd_file, line, "Invalid reload time of a block");
+
+        if (input_crpd_file.line != line || !end_of_line(&input_crpd_file))
+            parse_error(&input_crpd_file, line, "A cache footprint has to be given on one line");
+
+        if (footprint < 0 || useful_blocks < 0 || useful_blocks > footprint || block_reload_time < 0)
+            parse_error(&input_crpd_file, line, "The useful blocks have to be at most the footprint (and none of them negative)");
+
+        // Finding the task in the task-set.
+        for (int j = 0; j < num_tasks; j++)
+        {
+            if (tasks[j].task_num == task_num)
+            {
+                cache_footprints[j].footprint = footprint;
+                cache_footprints[j].useful_blocks = useful_blocks;
+                cache_footprints[j].block_reload_time = block_reload_time;
+            }
+        }
+    }
+
+    close_input_file(&input_crpd_file);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task number of the task that starts running at a cache impact point.
+ * Post-condition: Returns the time taken to reload the useful blocks of the task that were evicted since it last ran, and moves the task to the front of the LRU order.
+ *
+ * The cache holds the blocks of the most recently run tasks. So the blocks of a task are still resident as long as the footprints of the tasks that ran since
+ * it last ran, along with its own, fit in the cache. Of its evicted blocks, at most its useful blocks have to be reloaded (all of them the first time it runs).
+ */
+float
+find_cache_reload_time(int sorted_task_num)
+{
+    int position = 0;
+    long blocks_used_since = 0;
+    while (position < num_lru_tasks && lru_tasks[position] != sorted_task_num)
+        blocks_used_since += cache_footprints[lru_tasks[position++]].footprint;
+
+    Cache_footprint footprint = cache_footprints[sorted_task_num];
+    long resident_blocks = 0;
+    if (position < num_lru_tasks) // The task has run before.
+    {
+        resident_blocks = CACHE_SIZE_BLOCKS - blocks_used_since;
+        resident_blocks = (resident_blocks < 0) ? 0 : (resident_blocks > footprint.footprint) ? footprint.footprint : resident_blocks;
+    }
+    long evicted_blocks = footprint.footprint - resident_blocks;
+    long reloaded_blocks = (evicted_blocks < footprint.useful_blocks) ? evicted_blocks : footprint.useful_blocks;
+
+    // The task is now the most recently run one.
+    if (position == num_lru_tasks)
+        num_lru_tasks++;
+    for (int i = position; i > 0; i--)
+        lru_tasks[i] = lru_tasks[i - 1];
+    lru_tasks[0] = sorted_task_num;
+
+    float reload_time = reloaded_blocks * footprint.block_reload_time;
+    task_crpd_time[sorted_task_num] += reload_time;
+    task_reloaded_blocks[sorted_task_num] += reloaded_blocks;
+    if (reloaded_blocks > 0)
+        task_num_cache_reloads[sorted_task_num]++;
+
+    return reload_time;
+}
+
+
+/*
+ * Pre-condition: The sorted task number of the task that starts running at a cache impact point.
+ * Post-condition: The reload of its evicted useful blocks is added as an overhead (priced at the current level).
+ */
+void
+charge_cache_reload(int sorted_task_num)
+{
+    if (!CRPD_MODEL)
+        return;
+
+    float reload_time = find_cache_reload_time(sorted_task_num);
+    if (reload_time <= 0)
+        return;
+
+    fprintf(output_file, "Cache reload overhead of Task-%d being added. %0.2f + %0.2f = %0.2f\n", tasks[sorted_task_num].task_num, current_time, reload_time, current_time + reload_time);
+    trace_slice(TRACE_OVERHEAD_TID, "overhead", "Cache reload", current_time, current_time + reload_time);
+    log_record(LOG_OVERHEAD, current_freq_and_voltage_index, LOG_CACHE_RELOAD_OVERHEAD, sorted_task_num, current_time, current_time + reload_time, freq_and_voltage[current_freq_and_voltage_index].dynamic_power * reload_time, 0);
+    current_time += reload_time;
+    add_overhead_energy(reload_time);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The footprints of the tasks.
+ * Post-condition: Prints the footprint of every task onto the output file.
+ */
+void
+print_cache_footprints()
+{
+    fprintf(output_file, "------------------------------------------------------------\n");
+    fprintf(output_file, "Cache footprints (cache of %d blocks):\n", CACHE_SIZE_BLOCKS);
+    for (int i = 0; i < num_tasks; i++)
+        fprintf(output_file, "Task-%d: Footprint: %d blocks, Useful blocks: %d, Reload time of a block: %0.4f\n", tasks[i].task_num, cache_footprints[i].footprint, cache_footprints[i].useful_blocks, cache_footprints[i].block_reload_time);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The statistics of the tasks after the scheduler has finished.
+ * Post-condition: Prints the cache-related preemption delay of every task onto the statistics file.
+ */
+void
+print_crpd_statistics()
+{
+    if (!CRPD_MODEL)
+        return;
+
+    float total_crpd_time = 0;
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Cache-related preemption delay:\n");
+    for (int i = 0; i < num_tasks; i++)
+    {
+        fprintf(statistics_file, "Task-%d: Reloads: %ld, Reloaded blocks: %ld, CRPD time: %0.2f\n", tasks[i].task_num, task_num_cache_reloads[i], task_reloaded_blocks[i], task_crpd_time[i]);
+        total_crpd_time += task_crpd_time[i];
+    }
+    fprintf(statistics_file, "Total CRPD time: %0.2f\n", total_crpd_time);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The initialised model.
+ * Post-condition: Frees the footprints, the cache and the statistics.
+ */
+void
+delete_crpd()
+{
+    free(cache_footprints);
+    free(lru_tasks);
+    free(task_crpd_time);
+    free(task_num_cache_reloads);
+    free(task_reloaded_blocks);
+
+    return;
+}
@@ -0,0 +1,17 @@
+// Cache footprint of a task: the blocks its jobs touch and how many of them are useful (reused by the job after a cache impact point).
+typedef struct
+{
+    int footprint; // Evicting cache blocks.
+    int useful_blocks; // Useful cache blocks (at most the footprint).
+    float block_reload_time; // Time taken to reload one block.
+}
+Cache_footprint;
+
+// Functions.
+void init_crpd(); // Reads the cache footprints of the tasks (if the model is on) and empties the cache.
+void input_cache_footprints(); // Reads the footprint of every task given in the input file.
+float find_cache_reload_time(int); // Charges the reload of the evicted useful blocks of a task that starts running and returns its time.
+void charge_cache_reload(int); // Adds the cache-related preemption delay of a task that starts running at a cache impact point.
+void print_cache_footprints(); // Prints the footprint of every task.
+void print_crpd_statistics(); // Prints the cache-related preemption delay of every task.
+void delete_crpd(); // Frees the footprints, the cache and the statistics.
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "dpm.h"
+#include "trace.h"
+#include "schedule_log.h"
+#include "overhead.h"
+
+// Global variables required for dynamic power management.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+
+// Tasks and jobs.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
+extern _Thread_local int current_job_overall_job_index;
+
+extern _Thread_local long end_of_execution_time;
+extern _Thread_local float current_time;
+extern _Thread_local float total_dynamic_energy;
+extern _Thread_local float total_overhead_energy;
+
+// Sleep states of the core.
+static const Sleep_state sleep_states[NUM_SLEEP_STATES] = SLEEP_STATES;
+
+// How long the release of a job of every task (sorted based on period) can be procrastinated.
+_Thread_local float *procrastination_intervals;
+
+// Energy and time spent in the different states of the core. (The static energy is added up over the busy segments of the core in energy.c).
+_Thread_local float total_static_energy;
+_Thread_local float total_idle_energy;
+_Thread_local float total_sleep_energy;
+_Thread_local float total_transition_energy;
+_Thread_local float total_idle_time;
+_Thread_local float total_sleep_time;
+_Thread_local float total_procrastination_time;
+_Thread_local int num_sleeps[NUM_SLEEP_STATES];
+
+
+/*
+ * Pre-condition: The sorted task-set.
+ * Post-condition: Finds the procrastination intervals (if procrastination is enabled) and resets the energy accounting.
+ */
+void
+init_dpm()
+{
+    total_static_energy = 0;
+    total_idle_energy = 0;
+    total_sleep_energy = 0;
+    total_transition_energy = 0;
+    total_idle_time = 0;
+    total_sleep_time = 0;
+    total_procrastination_time = 0;
+    for (int i = 0; i < NUM_SLEEP_STATES; i++)
+        num_sleeps[i] = 0;
+
+    procrastination_intervals = (float *) calloc(num_tasks, sizeof(float));
+    if (DYNAMIC_PROCRASTINATION)
+        find_procrastination_intervals();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The task-set sorted based on period (RM priority).
+ * Post-condition: The procrastination interval of every task.
+ *
+ * The slack of task Ti is the largest idle time that can be inserted at its critical instant such that it still meets its deadline,
+ *      Si = max over the scheduling points t <= Di of (t - sum over tasks Tk with priority >= Ti of (ceil(t / Pk) * Ck'))
+ * where Ck' is the wcet of Tk along with the overheads a job can cause. Procrastinating a job also delays every lower priority job,
+ * so the procrastination interval of Ti is the smallest slack of Ti and all the lower priority tasks.
+ */
+void
+find_procrastination_intervals()
+{
+    float job_overheads = find_job_overheads(num_tasks);
+
+    for (int i = 0; i < num_tasks; i++) // Iterating through all tasks.
+    {
+        double slack = -1;
+
+        // The scheduling points of Ti are the releases of the tasks with priority >= Ti before its deadline, and its deadline.
+        for (int j = 0; j <= i; j++)
+        {
+            for (long t = tasks[j].period; t <= tasks[i].deadline + tasks[j].period; t += tasks[j].period)
+            {
+                long point = (t < tasks[i].deadline) ? t : tasks[i].deadline;
+
+                double demand = 0;
+                for (int k = 0; k <= i; k++)
+                    demand += ceil((double) point / tasks[k].period) * (tasks[k].wcet + job_overheads);
+
+                if (point - demand > slack)
+                    slack = point - demand;
+
+                if (point == tasks[i].deadline)
+                    break;
+            }
+        }
+
+        procrastination_intervals[i] = (slack > 0) ? slack : 0;
+    }
+
+    // A job cannot be procrastinated longer than any lower priority job.
+    for (int i = num_tasks - 2; i >= 0; i--)
+    {
+        if (procrastination_intervals[i + 1] < procrastination_intervals[i])
+            procrastination_intervals[i] = procrastination_intervals[i + 1];
+    }
+
+    fprintf(output_file, "------------------------------------------------------------\n");
+    fprintf(output_file, "Procrastination intervals: ");
+    for (int i = 0; i < num_tasks; i++)
+        fprintf(output_file, "Task-%d: %0.2f, ", tasks[i].task_num, procrastination_intervals[i]);
+    fprintf(output_file, "\n");
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The time of the next event while the core is idle.
+ * Post-condition: Returns the time till which the core can stay idle. Without procrastination, that is the next event.
+ *
+ * With procrastination, the next job release is procrastinated by the interval of its task, and every release within that interval can only shorten it. All these releases are handled together once the core wakes up.
+ */
+float
+find_wake_up_time(float next_event_time)
+{
+    int j = current_job_overall_job_index + 1;
+
+    // Only job releases are procrastinated (not the end of execution or an aperiodic arrival).
+    if (!DYNAMIC_PROCRASTINATION || j >= num_jobs || jobs[j].arrival_time > next_event_time)
+        return next_event_time;
+
+    float wake_up_time = jobs[j].arrival_time + procrastination_intervals[jobs[j].sorted_task_num];
+    for (; j < num_jobs && jobs[j].arrival_time < wake_up_time; j++)
+    {
+        if (jobs[j].arrival_time + procrastination_intervals[jobs[j].sorted_task_num] < wake_up_time)
+            wake_up_time = jobs[j].arrival_time + procrastination_intervals[jobs[j].sorted_task_num];
+    }
+
+    if (wake_up_time > end_of_execution_time)
+        wake_up_time = end_of_execution_time;
+
+    if (wake_up_time > next_event_time)
+    {
+        fprintf(output_file, "Job releases from t=%0.2f are procrastinated to t=%0.2f.\n", next_event_time, wake_up_time);
+        total_procrastination_time += wake_up_time - next_event_time;
+    }
+
+    return wake_up_time;
+}
+
+
+/*
+ * Pre-condition: The start and end of an interval in which the core has no job to run.
+ * Post-condition: The core idles or sleeps in the state that consumes the least energy over the interval. The energy is added to the idle, sleep and transition energy.
+ *
+ * Going to sleep costs (idle power - sleep power) * break-even time of extra energy, so that sleeping for exactly the break-even time costs the same as idling.
+ */
+void
+idle_core(float start_time, float end_time)
+{
+    float interval = end_time - start_time;
+    if (interval <= 0)
+        return;
+
+    int best_state = -1;
+    float best_energy = IDLE_POWER * interval;
+
+    if (DYNAMIC_POWER_MANAGEMENT)
+    {
+        for (int i = 0; i < NUM_SLEEP_STATES; i++)
+        {
+            // The core has to be able to wake up before the end of the interval.
+            if (interval < sleep_states[i].break_even_time || interval < sleep_states[i].wake_up_latency)
+                continue;
+
+            float energy = sleep_states[i].power * interval + (IDLE_POWER - sleep_states[i].power) * sleep_states[i].break_even_time;
+            if (energy < best_energy)
+            {
+                best_energy = energy;
+                best_state = i;
+            }
+        }
+    }
+
+    if (best_state < 0)
+    {
+        trace_slice(TRACE_IDLE_TID, "idle", "Idle", start_time, end_time);
+        log_record(LOG_IDLE, 0, -1, -1, start_time, end_time, best_energy, 0);
+        total_idle_energy += best_energy;
+        total_idle_time += interval;
+        return;
+    }
+
+    total_sleep_energy += sleep_states[best_state].power * interval;
+    total_transition_energy += (IDLE_POWER - sleep_states[best_state].power) * sleep_states[best_state].break_even_time;
+    total_sleep_time += interval;
+    num_sleeps[best_state]++;
+
+    char name[64];
+    snprintf(name, sizeof(name), "Sleep state %d", best_state);
+    trace_slice(TRACE_IDLE_TID, "idle", name, start_time, end_time);
+    log_record(LOG_IDLE, best_state + 1, -1, -1, start_time, end_time, sleep_states[best_state].power * interval, (IDLE_POWER - sleep_states[best_state].power) * sleep_states[best_state].break_even_time);
+
+    fprintf(output_file, "Core sleeping in sleep state %d from t=%0.2f to t=%0.2f (waking up from t=%0.2f).\n", best_state, start_time, end_time, end_time - sleep_states[best_state].wake_up_latency);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The energy accounting after the scheduler has finished (current time is the end of the schedule).
+ * Post-condition: Prints the static, idle, sleep and transition energy and the total energy onto the statistics file.
+ */
+void
+print_dpm_statistics()
+{
+    // The core consumes static power (of the level it is at) whenever it is not idle or sleeping.
+    float active_time = current_time - total_idle_time - total_sleep_time;
+
+    fprintf(statistics_file, "Total static-energy consumed: %0.2f (active for %0.2f units of time)\n", total_static_energy, active_time);
+    fprintf(statistics_file, "Total idle-energy consumed: %0.2f (idle for %0.2f units of time)\n", total_idle_energy, total_idle_time);
+    fprintf(statistics_file, "Total sleep-energy consumed: %0.2f (sleeping for %0.2f units of time)\n", total_sleep_energy, total_sleep_time);
+    fprintf(statistics_file, "Total transition-energy consumed: %0.2f\n", total_transition_energy);
+    fprintf(statistics_file, "Number of sleeps per sleep state: ");
+    for (int i = 0; i < NUM_SLEEP_STATES; i++)
+        fprintf(statistics_file, "%d, ", num_sleeps[i]);
+    fprintf(statistics_file, "\n");
+    if (DYNAMIC_PROCRASTINATION)
+        fprintf(statistics_file, "Total procrastination of job releases: %0.2f\n", total_procrastination_time);
+    fprintf(statistics_file, "Total energy consumed: %0.2f\n", find_total_energy());
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The energy accounting after the scheduler has finished.
+ * Post-condition: Returns the dynamic (of the jobs and the overheads), static, idle, sleep and transition energy together.
+ */
+float
+find_total_energy()
+{
+    return total_dynamic_energy + total_overhead_energy + total_static_energy + total_idle_energy + total_sleep_energy + total_transition_energy;
+}
+
+
+/*
+ * Pre-condition: The procrastination intervals.
+ * Post-condition: Frees the heap data related to dynamic power management.
+ */
+void
+delete_dpm()
+{
+    free(procrastination_intervals);
+    procrastination_intervals = NULL;
+
+    return;
+}
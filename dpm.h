@@ -0,0 +1,16 @@
+typedef struct
+{
+    float power; // Power consumed while in the sleep state.
+    float wake_up_latency; // Time it takes to wake up from the sleep state.
+    float break_even_time; // Shortest idle interval for which going to sleep saves energy.
+}
+Sleep_state;
+
+// Functions.
+void init_dpm(); // Finds the procrastination intervals of the tasks and initialises the energy accounting.
+void find_procrastination_intervals(); // Finds how long the release of the jobs of every task can be procrastinated using RM slack.
+float find_wake_up_time(float); // Finds till when the core can stay idle, given the next job release.
+void idle_core(float, float); // Accounts the energy of an idle interval (in the deepest sleep state that pays for itself).
+void print_dpm_statistics(); // Prints the static, idle, sleep and transition energy.
+float find_total_energy(); // Finds the total energy (including the dynamic energy) consumed by the core.
+void delete_dpm(); // Frees the data related to dynamic power management.
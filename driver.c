@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #include "configuration.h"
 #include "utility.h"
@@ -6,34 +8,109 @@
 #include "job.h"
 #include "freq_and_voltage.h"
 #include "scheduler.h"
+#include "parser.h"
+#include "histogram.h"
+#include "partition.h"
+#include "global_scheduler.h"
+#include "baseline.h"
+#include "checkpoint.h"
+
+/*
+ * Every simulation (one per core when the task-set is partitioned) runs in its own thread.
+ * So the state of a simulation is thread-local, while the inputs are only read by the main thread.
+ */
 
 // I/O Files.
-FILE *input_tasks_file;
-FILE *input_freq_file;
-FILE *output_file;
-FILE *statistics_file;
+Input_file input_tasks_file;
+Input_file input_freq_file;
+_Thread_local FILE *output_file;
+_Thread_local FILE *statistics_file;
+_Thread_local FILE *json_file; // Only the main thread writes the machine-readable statistics.
 
 // Variables to hold the task and job data.
-int num_tasks;
-Task *tasks;
+_Thread_local int num_tasks;
+_Thread_local Task *tasks;
 
-int num_jobs;
-Job *jobs;
+_Thread_local int num_jobs;
+_Thread_local Job *jobs;
 
 // Timing parameters of the program.
-long hyperperiod;
-long first_in_phase_time;
-long end_of_execution_time;
+_Thread_local long hyperperiod;
+_Thread_local long first_in_phase_time;
+_Thread_local long end_of_execution_time;
 
 // Global variables related to the DVFS part of the program.
-int num_freq_levels;
-Freq_and_voltage *freq_and_voltage;
-Freq_and_voltage static_freq_and_voltage;
-int static_freq_and_voltage_index;
+_Thread_local int num_freq_levels;
+_Thread_local Freq_and_voltage *freq_and_voltage;
+_Thread_local Freq_and_voltage static_freq_and_voltage;
+_Thread_local int static_freq_and_voltage_index;
+_Thread_local Level_transition *level_transitions; // Energy and latency of the change between every pair of levels.
+
+_Thread_local long num_freq_calculations;
+_Thread_local long num_freq_changes;
+_Thread_local float total_dynamic_energy;
+
+// Seed of the psuedo-random numbers (every core gets its own stream derived from it).
+unsigned long long simulation_seed;
+
+// Run-time flags of the policies that are evaluated against a baseline.
+extern _Thread_local int frequency_splitting;
+extern _Thread_local int aet_prediction;
+extern _Thread_local int preemption_threshold_scheduling;
+extern _Thread_local int slack_reclaiming;
+extern _Thread_local int frequency_hysteresis;
+
+// Whether the simulation of this thread takes snapshots (partitioned cores turn it on in their own threads).
+extern _Thread_local int checkpoints_enabled;
+
 
-long num_freq_calculations;
-long num_freq_changes;
-float total_dynamic_energy;
+// The policies that are evaluated against a baseline. If any of them is turned on, the schedule is simulated again in its own thread on the same task-set and seed
+// with all of them turned off (plain CC-RM, or plain RM for the thresholds), and both results are printed side by side onto the statistics file.
+// The flags are thread-local, so their addresses are taken in the thread that uses them.
+#define NUM_EVALUATED_POLICIES 5
+#define EVALUATED_POLICIES {&frequency_splitting, &aet_prediction, &preemption_threshold_scheduling, &slack_reclaiming, &frequency_hysteresis}
+static const char *const evaluated_policy_names[NUM_EVALUATED_POLICIES] = {"two-level frequency splitting", "execution time prediction", "preemption thresholds", "slack reclaiming", "frequency hysteresis"};
+
+
+/*
+ * Pre-condition: None. (Runs in the thread of the baseline simulation).
+ * Post-condition: Turns off the policies that are evaluated against the baseline.
+ */
+static void
+disable_evaluated_policies()
+{
+    int *evaluated_policies[NUM_EVALUATED_POLICIES] = EVALUATED_POLICIES;
+    for (int i = 0; i < NUM_EVALUATED_POLICIES; i++)
+        *evaluated_policies[i] = 0;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A buffer for the names of the policies.
+ * Post-condition: Returns the number of evaluated policies that are turned on, and their names (separated by commas) in the buffer.
+ */
+static int
+find_evaluated_policies(char *names, size_t size)
+{
+    int *evaluated_policies[NUM_EVALUATED_POLICIES] = EVALUATED_POLICIES;
+    int num_policies = 0;
+    names[0] = '\0';
+
+    for (int i = 0; i < NUM_EVALUATED_POLICIES; i++)
+    {
+        if (!*evaluated_policies[i])
+            continue;
+
+        if (num_policies > 0)
+            strncat(names, ", ", size - strlen(names) - 1);
+        strncat(names, evaluated_policy_names[i], size - strlen(names) - 1);
+        num_policies++;
+    }
+
+    return num_policies;
+}
 
 
 /*
@@ -42,6 +119,16 @@ float total_dynamic_energy;
  */
 int main(int argc, char const *argv[])
 {
+    /*
+     * "--convert" only converts the text inputs to a binary task-set cache, so that later runs can skip all the preprocessing.
+     * Function definition in utility.c
+     */
+    if (argc > 1 && strcmp(argv[1], "--convert") == 0)
+    {
+        convert_to_taskset_cache();
+        return 0;
+    }
+
     /*
      * Opens the input and output files. 
      * Initialises, sorts and prints the data.
@@ -52,8 +139,24 @@ int main(int argc, char const *argv[])
      */
     open_files_and_init_data();
 
-    /* Starts the scheduler and then schedules the entire task-set. */
-    start_scheduler();
+    /* Starts the scheduler and then schedules the entire task-set (on one core, globally on NUM_CORES cores or partitioned across NUM_CORES cores). */
+    simulation_seed = (RANDOM_SEED != 0) ? RANDOM_SEED : (unsigned long long) time(NULL);
+    if ((RESTORE_CHECKPOINT_TIME >= 0 || WHAT_IF_TASK >= 0) && !(NUM_CORES > 1 && GLOBAL_SCHEDULING)) // A resumed (or what-if) simulation uses the seed of the one that took the snapshots.
+        simulation_seed = find_checkpoint_seed();
+    if (NUM_CORES > 1 && GLOBAL_SCHEDULING)
+        start_global_scheduler();
+    else if (NUM_CORES > 1)
+        start_partitioned_scheduler();
+    else
+    {
+        checkpoints_enabled = 1;
+        start_scheduler();
+
+        // The energy and overheads of the evaluated policies are compared against the same schedule without them.
+        char policy_names[256];
+        if (find_evaluated_policies(policy_names, sizeof(policy_names)) > 0)
+            compare_with_baseline(disable_evaluated_policies, policy_names);
+    }
 
     /*
      * Takes care of things to be done when exiting from the program.
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "freq_and_voltage.h"
+#include "energy.h"
+
+// Global variables required to account the energy at every frequency level.
+
+// Output files.
+extern _Thread_local FILE *statistics_file;
+
+// Tasks and frequency (and voltage) data.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local int current_freq_and_voltage_index;
+extern _Thread_local Level_transition *level_transitions;
+extern _Thread_local float total_static_energy;
+
+// Time and energy of the overheads (decision making, frequency calculations and changes, and preemptions).
+_Thread_local float total_overhead_time;
+_Thread_local float total_overhead_energy;
+
+// Residency tables. The per-task tables are indexed by (sorted task number * number of levels + level).
+_Thread_local float *level_execution_time;
+_Thread_local float *level_execution_energy;
+_Thread_local float *level_overhead_time;
+_Thread_local float *level_overhead_energy;
+_Thread_local float *task_level_time;
+_Thread_local float *task_level_energy;
+
+
+/*
+ * Pre-condition: The sorted task-set and frequencies.
+ * Post-condition: Empty residency tables.
+ */
+void
+init_energy_accounting()
+{
+    total_overhead_time = 0;
+    total_overhead_energy = 0;
+
+    level_execution_time = (float *) calloc(num_freq_levels, sizeof(float));
+    level_execution_energy = (float *) calloc(num_freq_levels, sizeof(float));
+    level_overhead_time = (float *) calloc(num_freq_levels, sizeof(float));
+    level_overhead_energy = (float *) calloc(num_freq_levels, sizeof(float));
+    task_level_time = (float *) calloc(num_tasks * num_freq_levels, sizeof(float));
+    task_level_energy = (float *) calloc(num_tasks * num_freq_levels, sizeof(float));
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task number of the job that executed (-1 for an overhead interval), the level it executed at, and the length and energy of the segment.
+ * Post-condition: The segment is added to the residency tables, and its static energy to the total.
+ */
+void
+add_residency(int sorted_task_num, int level, float time, float energy)
+{
+    total_static_energy += freq_and_voltage[level].static_power * time;
+
+    if (sorted_task_num < 0)
+    {
+        total_overhead_time += time;
+        level_overhead_time[level] += time;
+        level_overhead_energy[level] += energy;
+        return;
+    }
+
+    level_execution_time[level] += time;
+    level_execution_energy[level] += energy;
+    task_level_time[sorted_task_num * num_freq_levels + level] += time;
+    task_level_energy[sorted_task_num * num_freq_levels + level] += energy;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The length of an overhead interval that has just been added to the current time.
+ * Post-condition: The overhead is priced at the current frequency and voltage (the core executes the scheduler in the meantime).
+ */
+void
+add_overhead_energy(float time)
+{
+    float energy = freq_and_voltage[current_freq_and_voltage_index].dynamic_power * time;
+
+    total_overhead_energy += energy;
+    add_residency(-1, current_freq_and_voltage_index, time, energy);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The levels before and after a frequency change.
+ * Post-condition: The energy of the change is added to the overhead energy (and the latency to the new level in the residency tables). Returns the latency of the change.
+ */
+float
+add_transition_energy(int from, int to)
+{
+    Level_transition transition = level_transitions[from * num_freq_levels + to];
+
+    total_overhead_energy += transition.energy;
+    add_residency(-1, to, transition.latency, transition.energy);
+
+    return transition.latency;
+}
+
+
+/*
+ * Pre-condition: The residency tables after the scheduler has finished.
+ * Post-condition: Prints the time and energy at every frequency level, overall and for every task, onto the statistics file.
+ */
+void
+print_residency_statistics()
+{
+    float total_time = 0;
+    for (int i = 0; i < num_freq_levels; i++)
+        total_time += level_execution_time[i] + level_overhead_time[i];
+
+    fprintf(statistics_file, "\nFrequency residency statistics:\n");
+    fprintf(statistics_file, "Disclaimer: Residency is the share of the busy time (jobs and overheads) of the core spent at a level. Idle and sleep intervals are accounted separately.\n");
+    fprintf(statistics_file, "Total overhead-energy consumed: %0.2f\n", total_overhead_energy);
+    for (int i = 0; i < num_freq_levels; i++) // Iterates over every level.
+    {
+        float level_time = level_execution_time[i] + level_overhead_time[i];
+        fprintf(statistics_file, "Level %d (%0.2f, %0.2fV): Job time: %0.2f, Job energy: %0.2f, Overhead time: %0.2f, Overhead energy: %0.2f, Residency: %0.1f%%\n", i, freq_and_voltage[i].freq, freq_and_voltage[i].voltage, level_execution_time[i], level_execution_energy[i], level_overhead_time[i], level_overhead_energy[i], (total_time > 0) ? 100 * level_time / total_time : 0);
+    }
+
+    for (int i = 0; i < num_tasks; i++) // Iterates over every task.
+    {
+        fprintf(statistics_file, "Task-%d: ", tasks[i].task_num);
+        for (int j = 0; j < num_freq_levels; j++)
+            fprintf(statistics_file, "%0.2f: %0.2f (%0.2f), ", freq_and_voltage[j].freq, task_level_time[i * num_freq_levels + j], task_level_energy[i * num_freq_levels + j]);
+        fprintf(statistics_file, "\n");
+    }
+    fprintf(statistics_file, "\t(Level: Time (Energy))\n");
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The residency tables.
+ * Post-condition: Frees the residency tables.
+ */
+void
+delete_energy_accounting()
+{
+    free(level_execution_time);
+    free(level_execution_energy);
+    free(level_overhead_time);
+    free(level_overhead_energy);
+    free(task_level_time);
+    free(task_level_energy);
+
+    return;
+}
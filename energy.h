@@ -0,0 +1,7 @@
+// Functions.
+void init_energy_accounting(); // Initialises the per-level residency tables.
+void add_residency(int, int, float, float); // Adds an executed segment of a task (or an overhead interval) to the residency tables.
+void add_overhead_energy(float); // Prices an overhead interval at the current frequency and voltage.
+float add_transition_energy(int, int); // Prices a frequency change using the transition table (returns its latency).
+void print_residency_statistics(); // Prints the time and energy spent at every frequency level (per task and overall).
+void delete_energy_accounting(); // Frees the residency tables.
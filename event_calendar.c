@@ -0,0 +1,470 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "event_calendar.h"
+#include "checkpoint.h"
+
+#define CALENDAR_POOL_BLOCK_SIZE 256
+
+/*
+ * The calendar is a hierarchical timing wheel (Varghese and Lauck).
+ * Wheel l holds the events that are in the same block of 64^(l+1) ticks as the current tick, but not in the same block of 64^l ticks.
+ * So wheel 0 holds the events of the next (at most) 64 ticks, each in its own slot, and every slot of a higher wheel holds a whole block of ticks.
+ * When the current tick moves into a new block, the events of the slot of that block are moved down to the lower wheels.
+ * Events further away than the highest wheel wait in an overflow list.
+ */
+static _Thread_local Calendar_event *wheels[CALENDAR_NUM_LEVELS][CALENDAR_NUM_SLOTS];
+static _Thread_local unsigned long long occupied_slots[CALENDAR_NUM_LEVELS]; // Bit i is set when slot i of the wheel has events.
+static _Thread_local Calendar_event *overflow_events;
+static _Thread_local unsigned long long current_tick;
+
+static _Thread_local int num_events;
+static _Thread_local unsigned long num_scheduled_events; // Used as the sequence number of the next event.
+static _Thread_local Calendar_event *next_event; // Cached result of peek_calendar_event() (NULL if it has to be found again).
+
+// Events are allocated in blocks and reused through a free list.
+static _Thread_local Calendar_event *free_events;
+static _Thread_local Calendar_event **pool_blocks;
+static _Thread_local int num_pool_blocks;
+
+
+/*
+ * Pre-condition: Two events.
+ * Post-condition: Returns 1 if the first event has to be handled before the second one, 0 otherwise.
+ */
+static int
+calendar_event_before(const Calendar_event *a, const Calendar_event *b)
+{
+    if (a->time != b->time)
+        return a->time < b->time;
+    if (a->type != b->type)
+        return a->type < b->type;
+
+    return a->sequence < b->sequence;
+}
+
+
+/*
+ * Pre-condition: An event that is not in the timing wheel.
+ * Post-condition: The event is linked into the right wheel and slot (or into the overflow list) relative to the current tick.
+ */
+static void
+link_calendar_event(Calendar_event *calendar_event)
+{
+    // Events are never placed before the current tick.
+    if (calendar_event->tick < current_tick)
+        calendar_event->tick = current_tick;
+
+    Calendar_event **list = &overflow_events;
+    calendar_event->level = -1;
+    calendar_event->slot = -1;
+
+    for (int level = 0; level < CALENDAR_NUM_LEVELS; level++)
+    {
+        int block_shift = CALENDAR_SLOT_BITS * (level + 1);
+        if ((calendar_event->tick >> block_shift) == (current_tick >> block_shift)) // Same block as the current tick at this wheel.
+        {
+            calendar_event->level = level;
+            calendar_event->slot = (calendar_event->tick >> (CALENDAR_SLOT_BITS * level)) & (CALENDAR_NUM_SLOTS - 1);
+            list = &wheels[level][calendar_event->slot];
+            occupied_slots[level] |= 1ULL << calendar_event->slot;
+            break;
+        }
+    }
+
+    calendar_event->prev = NULL;
+    calendar_event->next = *list;
+    if (*list)
+        (*list)->prev = calendar_event;
+    *list = calendar_event;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An event that is in the timing wheel.
+ * Post-condition: The event is removed from its wheel and slot (or from the overflow list).
+ */
+static void
+unlink_calendar_event(Calendar_event *calendar_event)
+{
+    Calendar_event **list = (calendar_event->level == -1) ? &overflow_events : &wheels[calendar_event->level][calendar_event->slot];
+
+    if (calendar_event->prev)
+        calendar_event->prev->next = calendar_event->next;
+    else
+        *list = calendar_event->next;
+
+    if (calendar_event->next)
+        calendar_event->next->prev = calendar_event->prev;
+
+    if (calendar_event->level != -1 && *list == NULL)
+        occupied_slots[calendar_event->level] &= ~(1ULL << calendar_event->slot);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A new tick which is not after the tick of any event in the calendar.
+ * Post-condition: The current tick is moved to the new tick and the events are moved down the wheels where required.
+ */
+static void
+advance_calendar(unsigned long long tick)
+{
+    if (tick <= current_tick)
+        return;
+
+    unsigned long long prev_tick = current_tick;
+    current_tick = tick;
+
+    // If the highest wheel moved into a new block, the events in the overflow list might fit into the wheels now.
+    if ((prev_tick >> (CALENDAR_SLOT_BITS * CALENDAR_NUM_LEVELS)) != (current_tick >> (CALENDAR_SLOT_BITS * CALENDAR_NUM_LEVELS)))
+    {
+        Calendar_event *calendar_event = overflow_events;
+        overflow_events = NULL;
+        while (calendar_event)
+        {
+            Calendar_event *next = calendar_event->next;
+            link_calendar_event(calendar_event);
+            calendar_event = next;
+        }
+    }
+
+    // The slot of the new current tick in every higher wheel has to be moved down (starting from the highest wheel).
+    for (int level = CALENDAR_NUM_LEVELS - 1; level > 0; level--)
+    {
+        int slot = (current_tick >> (CALENDAR_SLOT_BITS * level)) & (CALENDAR_NUM_SLOTS - 1);
+        Calendar_event *calendar_event = wheels[level][slot];
+        if (!calendar_event)
+            continue;
+
+        wheels[level][slot] = NULL;
+        occupied_slots[level] &= ~(1ULL << slot);
+        while (calendar_event)
+        {
+            Calendar_event *next = calendar_event->next;
+            link_calendar_event(calendar_event);
+            calendar_event = next;
+        }
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: Nothing.
+ * Post-condition: An empty event calendar starting from t=0.
+ */
+void
+init_event_calendar()
+{
+    for (int level = 0; level < CALENDAR_NUM_LEVELS; level++)
+    {
+        for (int slot = 0; slot < CALENDAR_NUM_SLOTS; slot++)
+            wheels[level][slot] = NULL;
+        occupied_slots[level] = 0;
+    }
+
+    overflow_events = NULL;
+    current_tick = 0;
+    num_events = 0;
+    num_scheduled_events = 0;
+    next_event = NULL;
+    free_events = NULL;
+    pool_blocks = NULL;
+    num_pool_blocks = 0;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The event calendar.
+ * Post-condition: Frees the memory of all the events (scheduled or not).
+ */
+void
+delete_event_calendar()
+{
+    for (int i = 0; i < num_pool_blocks; i++)
+        free(pool_blocks[i]);
+    free(pool_blocks);
+
+    init_event_calendar();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The time and type of the event and the related job (-1 if there is none). The time cannot be before the last event that was popped.
+ * Post-condition: Schedules the event and returns it (so that it can be cancelled later).
+ */
+Calendar_event *
+schedule_calendar_event(double time, Calendar_event_type type, int job_index)
+{
+    // Allocating a new block of events if there are no free events left.
+    if (!free_events)
+    {
+        Calendar_event *block = (Calendar_event *) malloc(sizeof(Calendar_event) * CALENDAR_POOL_BLOCK_SIZE);
+        pool_blocks = (Calendar_event **) realloc(pool_blocks, sizeof(Calendar_event *) * (num_pool_blocks + 1));
+        pool_blocks[num_pool_blocks++] = block;
+
+        for (int i = 0; i < CALENDAR_POOL_BLOCK_SIZE; i++)
+        {
+            block[i].next = free_events;
+            free_events = &block[i];
+        }
+    }
+
+    Calendar_event *calendar_event = free_events;
+    free_events = calendar_event->next;
+
+    calendar_event->time = time;
+    calendar_event->tick = (time > 0) ? (unsigned long long) (time * CALENDAR_TICKS_PER_TIME_UNIT) : 0;
+    calendar_event->type = type;
+    calendar_event->job_index = job_index;
+    calendar_event->sequence = num_scheduled_events++;
+    link_calendar_event(calendar_event);
+    num_events++;
+
+    // The cached next event only changes if the new event comes before it.
+    if (next_event && calendar_event_before(calendar_event, next_event))
+        next_event = calendar_event;
+
+    return calendar_event;
+}
+
+
+/*
+ * Pre-condition: An event that is scheduled in the calendar.
+ * Post-condition: The event is removed from the calendar and freed.
+ */
+void
+cancel_calendar_event(Calendar_event *calendar_event)
+{
+    unlink_calendar_event(calendar_event);
+    num_events--;
+
+    if (next_event == calendar_event)
+        next_event = NULL;
+
+    calendar_event->next = free_events;
+    free_events = calendar_event;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The event calendar.
+ * Post-condition: The next event to be handled (NULL if the calendar is empty). The event stays in the calendar.
+ */
+Calendar_event *
+peek_calendar_event()
+{
+    if (next_event || num_events == 0)
+        return next_event;
+
+    // The first occupied slot of the lowest non-empty wheel holds the next event. Only that slot has to be searched.
+    Calendar_event *list = NULL;
+    for (int level = 0; level < CALENDAR_NUM_LEVELS && !list; level++)
+    {
+        if (occupied_slots[level])
+            list = wheels[level][__builtin_ctzll(occupied_slots[level])];
+    }
+
+    if (!list)
+        list = overflow_events;
+
+    for (Calendar_event *calendar_event = list; calendar_event; calendar_event = calendar_event->next)
+    {
+        if (!next_event || calendar_event_before(calendar_event, next_event))
+            next_event = calendar_event;
+    }
+
+    return next_event;
+}
+
+
+/*
+ * Pre-condition: A non-empty event calendar.
+ * Post-condition: Removes and returns (a copy of) the next event. The calendar moves forward to the time of the event.
+ */
+Calendar_event
+pop_calendar_event()
+{
+    Calendar_event *calendar_event = peek_calendar_event();
+    Calendar_event popped_event = *calendar_event;
+
+    cancel_calendar_event(calendar_event);
+    advance_calendar(popped_event.tick);
+
+    return popped_event;
+}
+
+
+/*
+ * Pre-condition: The event calendar.
+ * Post-condition: The number of events that are scheduled.
+ */
+int
+num_calendar_events()
+{
+    return num_events;
+}
+
+
+/*
+ * Pre-condition: A snapshot open for writing.
+ * Post-condition: The current tick, the next sequence number and all the scheduled events are written to the snapshot.
+ */
+void
+save_event_calendar(FILE *file)
+{
+    write_checkpoint_data(file, &current_tick, sizeof(current_tick));
+    write_checkpoint_data(file, &num_scheduled_events, sizeof(num_scheduled_events));
+    write_checkpoint_data(file, &num_events, sizeof(num_events));
+
+    for (int level = -1; level < CALENDAR_NUM_LEVELS; level++)
+    {
+        for (int slot = 0; slot < ((level == -1) ? 1 : CALENDAR_NUM_SLOTS); slot++)
+        {
+            for (Calendar_event *calendar_event = (level == -1) ? overflow_events : wheels[level][slot]; calendar_event; calendar_event = calendar_event->next)
+            {
+                // The position of the event in the timing wheel is found again when it is restored.
+                write_checkpoint_data(file, &calendar_event->time, sizeof(calendar_event->time));
+                write_checkpoint_data(file, &calendar_event->type, sizeof(calendar_event->type));
+                write_checkpoint_data(file, &calendar_event->job_index, sizeof(calendar_event->job_index));
+                write_checkpoint_data(file, &calendar_event->sequence, sizeof(calendar_event->sequence));
+            }
+        }
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A snapshot open for reading, at the event calendar written by save_event_calendar().
+ * Post-condition: The event calendar holds the events of the snapshot (with their sequence numbers), so they are handled in the same order.
+ */
+void
+restore_event_calendar(FILE *file)
+{
+    delete_event_calendar();
+
+    int num_saved_events;
+    unsigned long saved_num_scheduled_events;
+    read_checkpoint_data(file, &current_tick, sizeof(current_tick));
+    read_checkpoint_data(file, &saved_num_scheduled_events, sizeof(saved_num_scheduled_events));
+    read_checkpoint_data(file, &num_saved_events, sizeof(num_saved_events));
+
+    // The order of the events only depends on their time, type and sequence number (and their ticks are found again relative to the same current tick).
+    for (int i = 0; i < num_saved_events; i++)
+    {
+        Calendar_event saved_event;
+        read_checkpoint_data(file, &saved_event.time, sizeof(saved_event.time));
+        read_checkpoint_data(file, &saved_event.type, sizeof(saved_event.type));
+        read_checkpoint_data(file, &saved_event.job_index, sizeof(saved_event.job_index));
+        read_checkpoint_data(file, &saved_event.sequence, sizeof(saved_event.sequence));
+        Calendar_event *calendar_event = schedule_calendar_event(saved_event.time, saved_event.type, saved_event.job_index);
+        calendar_event->sequence = saved_event.sequence;
+    }
+    num_scheduled_events = saved_num_scheduled_events;
+    next_event = NULL;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sequence number of an event.
+ * Post-condition: Returns the scheduled event with the sequence number (NULL if there is none).
+ */
+Calendar_event *
+find_calendar_event(unsigned long sequence)
+{
+    for (int level = -1; level < CALENDAR_NUM_LEVELS; level++)
+    {
+        for (int slot = 0; slot < ((level == -1) ? 1 : CALENDAR_NUM_SLOTS); slot++)
+        {
+            for (Calendar_event *calendar_event = (level == -1) ? overflow_events : wheels[level][slot]; calendar_event; calendar_event = calendar_event->next)
+            {
+                if (calendar_event->sequence == sequence)
+                    return calendar_event;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Pre-condition: Two events.
+ * Post-condition: Compares the events in the order they are handled (for qsort).
+ */
+static int
+calendar_event_comparator(const void *a, const void *b)
+{
+    if (calendar_event_before((const Calendar_event *) a, (const Calendar_event *) b))
+        return -1;
+
+    return calendar_event_before((const Calendar_event *) b, (const Calendar_event *) a);
+}
+
+
+/*
+ * Pre-condition: A snapshot open for reading, at the event calendar written by save_event_calendar().
+ * Post-condition: Returns 1 if the events of the snapshot would be handled in the same order as the scheduled ones, 0 otherwise. The events of the snapshot are read past either way.
+ *
+ * Two simulations number their events differently, so only the order of the events matters (not their sequence numbers).
+ */
+int
+compare_event_calendar(FILE *file)
+{
+    unsigned long long saved_tick;
+    unsigned long saved_num_scheduled_events;
+    int num_saved_events;
+    read_checkpoint_data(file, &saved_tick, sizeof(saved_tick));
+    read_checkpoint_data(file, &saved_num_scheduled_events, sizeof(saved_num_scheduled_events));
+    read_checkpoint_data(file, &num_saved_events, sizeof(num_saved_events));
+
+    Calendar_event *saved_events = (Calendar_event *) malloc(sizeof(Calendar_event) * (num_saved_events + 1));
+    for (int i = 0; i < num_saved_events; i++)
+    {
+        read_checkpoint_data(file, &saved_events[i].time, sizeof(saved_events[i].time));
+        read_checkpoint_data(file, &saved_events[i].type, sizeof(saved_events[i].type));
+        read_checkpoint_data(file, &saved_events[i].job_index, sizeof(saved_events[i].job_index));
+        read_checkpoint_data(file, &saved_events[i].sequence, sizeof(saved_events[i].sequence));
+    }
+
+    int same = (num_saved_events == num_events);
+    if (same)
+    {
+        // Both sets of events in the order they are handled.
+        Calendar_event *scheduled_events = (Calendar_event *) malloc(sizeof(Calendar_event) * (num_events + 1));
+        int num_scheduled = 0;
+        for (int level = -1; level < CALENDAR_NUM_LEVELS; level++)
+        {
+            for (int slot = 0; slot < ((level == -1) ? 1 : CALENDAR_NUM_SLOTS); slot++)
+            {
+                for (Calendar_event *calendar_event = (level == -1) ? overflow_events : wheels[level][slot]; calendar_event; calendar_event = calendar_event->next)
+                    scheduled_events[num_scheduled++] = *calendar_event;
+            }
+        }
+        qsort(scheduled_events, num_scheduled, sizeof(Calendar_event), calendar_event_comparator);
+        qsort(saved_events, num_saved_events, sizeof(Calendar_event), calendar_event_comparator);
+
+        for (int i = 0; i < num_events && same; i++)
+            same = (scheduled_events[i].time == saved_events[i].time && scheduled_events[i].type == saved_events[i].type && scheduled_events[i].job_index == saved_events[i].job_index);
+        free(scheduled_events);
+    }
+    free(saved_events);
+
+    return same;
+}
@@ -0,0 +1,47 @@
+// Parameters of the hierarchical timing wheel.
+#define CALENDAR_NUM_LEVELS 6 // Number of wheels.
+#define CALENDAR_SLOT_BITS 6 // Each wheel has 2^6 = 64 slots.
+#define CALENDAR_NUM_SLOTS (1 << CALENDAR_SLOT_BITS)
+
+// Types of events in the event calendar. When two events happen at the same time, they are handled in this order.
+typedef enum
+{
+    CALENDAR_JOB_COMPLETION, // The running job finishes its execution.
+    CALENDAR_DEADLINE_CHECK, // The absolute deadline of an admitted job is reached.
+    CALENDAR_FREQUENCY_SWITCH, // The running job switches to the second frequency of a split allocation window.
+    CALENDAR_PREDICTION_OVERRUN, // The running job has executed for its predicted time without finishing.
+    CALENDAR_APERIODIC_ARRIVAL, // An aperiodic or sporadic job arrives (before the server job released at the same time looks for work).
+    CALENDAR_SERVER_REPLENISHMENT, // The sporadic server gets back some of its budget.
+    CALENDAR_JOB_RELEASE, // A new job arrives.
+    CALENDAR_HORIZON_END // The end of execution time is reached.
+}
+Calendar_event_type;
+
+typedef struct Calendar_event
+{
+    double time; // Exact time of the event.
+    unsigned long long tick; // Time of the event in ticks of the timing wheel.
+    Calendar_event_type type;
+    int job_index; // Index of the related job in the jobs array (-1 if the event is not related to a job).
+    unsigned long sequence; // Order of scheduling (to break ties between events of the same type at the same time).
+
+    // Position of the event in the timing wheel.
+    int level; // -1 when the event is in the overflow list.
+    int slot;
+    struct Calendar_event *prev;
+    struct Calendar_event *next;
+}
+Calendar_event;
+
+// Functions.
+void init_event_calendar(); // Initialises an empty event calendar starting from t=0.
+void delete_event_calendar(); // Frees all the events of the event calendar.
+Calendar_event *schedule_calendar_event(double, Calendar_event_type, int); // Schedules an event of the given type at the given time.
+void cancel_calendar_event(Calendar_event *); // Removes a scheduled event from the event calendar.
+Calendar_event *peek_calendar_event(); // Returns the next event without removing it (NULL if there are no events).
+Calendar_event pop_calendar_event(); // Removes and returns the next event (the calendar must not be empty).
+int num_calendar_events(); // The number of events scheduled in the event calendar.
+void save_event_calendar(FILE *); // Writes the scheduled events to a snapshot.
+void restore_event_calendar(FILE *); // Replaces the scheduled events with those of a snapshot.
+Calendar_event *find_calendar_event(unsigned long); // The scheduled event with the given sequence number.
+int compare_event_calendar(FILE *); // Checks whether the events of a snapshot would be handled in the same order as the scheduled ones.
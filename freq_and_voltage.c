@@ -1,21 +1,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "configuration.h"
 #include "freq_and_voltage.h"
 #include "utility.h"
 #include "task.h"
+#include "parser.h"
+#include "overhead.h"
 
-extern FILE *input_freq_file;
-extern int num_freq_levels;
-extern Freq_and_voltage *freq_and_voltage;
+extern Input_file input_freq_file;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Level_transition *level_transitions;
 
-extern FILE *output_file;
+// Transitions given in the input file (as pairs of frequencies), till they are looked up in the sorted levels.
+static int num_input_transitions;
+static float (*input_transitions)[4];
 
-extern Freq_and_voltage static_freq_and_voltage;
-extern int static_freq_and_voltage_index;
+extern _Thread_local FILE *output_file;
 
-extern int num_tasks;
-extern Task *tasks;
+extern _Thread_local Freq_and_voltage static_freq_and_voltage;
+extern _Thread_local int static_freq_and_voltage_index;
+
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
 
 
 /*
@@ -25,11 +33,13 @@ extern Task *tasks;
 void
 input_sort_print_freq_and_voltage()
 {
-    // Input the frequencies.
+    // Input the frequencies (along with the optional power model).
     input_freq_and_voltage();
+    input_level_transitions();
 
     // Sort the frequencies.
     sort_freq_and_voltage();
+    find_level_transitions();
 
     // Print the frequencies.
     print_freq_and_voltage();
@@ -48,27 +58,144 @@ input_sort_print_freq_and_voltage()
 void
 input_freq_and_voltage()
 {
-    fscanf(input_freq_file, "%d", &num_freq_levels);
+    long num_freq_levels_input;
+    if (!scan_long(&input_freq_file, &num_freq_levels_input) || num_freq_levels_input <= 0)
+        parse_error(&input_freq_file, input_freq_file.line, "Invalid number of frequency levels");
+    num_freq_levels = num_freq_levels_input;
 
     freq_and_voltage = (Freq_and_voltage *) malloc(sizeof(Freq_and_voltage) * num_freq_levels);
 
     for (int i = 0; i < num_freq_levels; i++)
     {
-        fscanf(input_freq_file, "%f %f", &freq_and_voltage[i].freq, &freq_and_voltage[i].voltage);
+        // Every frequency level is on its own line.
+        skip_whitespace(&input_freq_file);
+        int line = input_freq_file.line;
+
+        if (!scan_float(&input_freq_file, &freq_and_voltage[i].freq) || !scan_float(&input_freq_file, &freq_and_voltage[i].voltage))
+            parse_error(&input_freq_file, line, "Expected a frequency and a voltage");
+
+        // The measured dynamic and static power of the level are optional. Without them, the level follows the CMOS model.
+        freq_and_voltage[i].dynamic_power = freq_and_voltage[i].voltage * freq_and_voltage[i].voltage * freq_and_voltage[i].freq;
+        freq_and_voltage[i].static_power = STATIC_POWER;
+        if (input_freq_file.line == line && !end_of_line(&input_freq_file))
+        {
+            if (!scan_float(&input_freq_file, &freq_and_voltage[i].dynamic_power) || !scan_float(&input_freq_file, &freq_and_voltage[i].static_power))
+                parse_error(&input_freq_file, line, "Expected the dynamic and static power of a frequency level");
+        }
+
+        if (input_freq_file.line != line || !end_of_line(&input_freq_file))
+            parse_error(&input_freq_file, line, "A frequency level has to be given as two (or four, with its power) values on one line");
 
         // Checking for invalid input. Frequency cannot be non-positive and greater than 1. Voltage cannot be non-positive.
-        if (freq_and_voltage[i].freq <= 0 || freq_and_voltage[i].freq > 1 || freq_and_voltage[i].voltage <= 0)
+        if (freq_and_voltage[i].freq <= 0 || freq_and_voltage[i].freq > 1 || freq_and_voltage[i].voltage <= 0 || freq_and_voltage[i].dynamic_power < 0 || freq_and_voltage[i].static_power < 0)
+            parse_error(&input_freq_file, line, "Invalid input in frequency input file");
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The frequency levels have been read from the input file.
+ * Post-condition: The optional transitions (the number of transitions followed by "from-frequency to-frequency energy latency" on every line) are read.
+ */
+void
+input_level_transitions()
+{
+    num_input_transitions = 0;
+    input_transitions = NULL;
+
+    // The transitions are optional, so the file can also end (or go on to the instructions) after the levels.
+    long num_transitions_input;
+    if (!scan_long(&input_freq_file, &num_transitions_input))
+        return;
+    if (num_transitions_input < 0)
+        parse_error(&input_freq_file, input_freq_file.line, "Invalid number of frequency transitions");
+    num_input_transitions = num_transitions_input;
+
+    input_transitions = malloc(sizeof(*input_transitions) * num_input_transitions);
+
+    for (int i = 0; i < num_input_transitions; i++)
+    {
+        // Every transition is on its own line.
+        skip_whitespace(&input_freq_file);
+        int line = input_freq_file.line;
+
+        for (int j = 0; j < 4; j++)
         {
-            fprintf(stderr, "ERROR: Invalid input in frequency input file. Please enter valid data\n");
+            if (!scan_float(&input_freq_file, &input_transitions[i][j]))
+                parse_error(&input_freq_file, line, "Expected the two frequencies, the energy and the latency of a transition");
+        }
+
+        if (input_freq_file.line != line || !end_of_line(&input_freq_file))
+            parse_error(&input_freq_file, line, "A transition has to be given as exactly four values on one line");
+
+        if (input_transitions[i][2] < 0 || input_transitions[i][3] < 0)
+            parse_error(&input_freq_file, line, "Invalid transition energy or latency");
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted frequency levels and the transitions read from the input file.
+ * Post-condition: The lookup table of the transition energy and latency of every pair of levels.
+ *
+ * A transition that is not given takes FREQUENCY_CHANGE_OVERHEAD units of time and is priced at the dynamic power of the new level.
+ */
+void
+find_level_transitions()
+{
+    level_transitions = (Level_transition *) malloc(sizeof(Level_transition) * num_freq_levels * num_freq_levels);
+
+    for (int i = 0; i < num_freq_levels; i++)
+    {
+        for (int j = 0; j < num_freq_levels; j++)
+        {
+            level_transitions[i * num_freq_levels + j].latency = (i == j) ? 0 : FREQUENCY_CHANGE_OVERHEAD;
+            level_transitions[i * num_freq_levels + j].energy = level_transitions[i * num_freq_levels + j].latency * freq_and_voltage[j].dynamic_power;
+        }
+    }
+
+    for (int i = 0; i < num_input_transitions; i++)
+    {
+        int from = find_freq_level(input_transitions[i][0]);
+        int to = find_freq_level(input_transitions[i][1]);
+        if (from < 0 || to < 0)
+        {
+            fprintf(stderr, "ERROR: The transition from %0.2f to %0.2f is not between two frequency levels (%s). Please enter valid data.\n", input_transitions[i][0], input_transitions[i][1], input_freq_file.file_name);
             exit(0);
         }
 
+        level_transitions[from * num_freq_levels + to].energy = input_transitions[i][2];
+        level_transitions[from * num_freq_levels + to].latency = input_transitions[i][3];
     }
 
+    free(input_transitions);
+    input_transitions = NULL;
+
     return;
 }
 
 
+/*
+ * Pre-condition: The sorted frequency levels.
+ * Post-condition: Returns the index of the level with the given frequency (-1 if there is no such level).
+ */
+int
+find_freq_level(float freq)
+{
+    for (int i = 0; i < num_freq_levels; i++)
+    {
+        if (freq_and_voltage[i].freq > freq - 0.0001 && freq_and_voltage[i].freq < freq + 0.0001)
+            return i;
+    }
+
+    return -1;
+}
+
+
 /*
  * Pre-condition: Two frequency instances.
  * Post-condition: An integer value of the comparision between the two frequency instances.
@@ -99,7 +226,7 @@ sort_freq_and_voltage()
 
 /*
  * Pre-condition: The arrays containing the values of freq and voltages.
- * Post-condition: Prints the freq and voltage values onto the output file.
+ * Post-condition: Prints the freq and voltage values (along with the power model) onto the output file.
  */
 void
 print_freq_and_voltage()
@@ -113,6 +240,25 @@ print_freq_and_voltage()
     }
     fprintf(output_file, "\n");
 
+    fprintf(output_file, "Power model (dynamic power, static power): ");
+    for (int i = 0; i < num_freq_levels; i++)
+    {
+        fprintf(output_file, "%0.2f: (%0.2f, %0.2f), ", freq_and_voltage[i].freq, freq_and_voltage[i].dynamic_power, freq_and_voltage[i].static_power);
+    }
+    fprintf(output_file, "\n");
+
+    fprintf(output_file, "Transitions (energy, latency):\n");
+    for (int i = 0; i < num_freq_levels; i++)
+    {
+        fprintf(output_file, "From %0.2f: ", freq_and_voltage[i].freq);
+        for (int j = 0; j < num_freq_levels; j++)
+        {
+            if (i != j)
+                fprintf(output_file, "%0.2f: (%0.2f, %0.2f), ", freq_and_voltage[j].freq, level_transitions[i * num_freq_levels + j].energy, level_transitions[i * num_freq_levels + j].latency);
+        }
+        fprintf(output_file, "\n");
+    }
+
     return;
 }
 
@@ -125,6 +271,7 @@ void
 delete_freq_and_voltage()
 {
     free(freq_and_voltage);
+    free(level_transitions);
 
     return;
 }
@@ -159,6 +306,8 @@ find_static_freq_and_voltage()
     static_freq_and_voltage.freq = freq_and_voltage[static_freq_and_voltage_index].freq;
     static_freq_and_voltage.voltage = freq_and_voltage[static_freq_and_voltage_index].voltage;
     fprintf(output_file, "This task-set demands static freq: %0.2f, static voltage: %0.2f\n", static_freq_and_voltage.freq, static_freq_and_voltage.voltage);
+    if (OVERHEAD_AWARE_STATIC_FREQUENCY)
+        print_static_slack_margins();
 
     return;
 }
@@ -171,26 +320,39 @@ find_static_freq_and_voltage()
 int
 rm_test(float relative_freq)
 {
-    /*
-     * For all tasks Ti and Periods sorted in ascending order,
-     *      if (floor(Pi/P1) * C1) + (floor(Pi/P2) * C2) + ......... + (floor(Pi/Pi) * Ci) <= relative_freq * Pi
-     *      then return 1
-     *      else 0
-     */
-    for (int i = 0; i < num_tasks; i++) // Iterating through all tasks.
-    {
-        float sum = 0;
-        for (int k = 0; k <= i; k++) // Iterating till the ith period.
-        {
-            int int_divide = tasks[i].period / tasks[k].period;
-            sum += int_divide * tasks[k].wcet;
-        }
+    // The overhead-aware test charges every job with the same overheads as the schedulability tests with SCHEDULABILITY_WITH_OVERHEADS.
+    if (OVERHEAD_AWARE_STATIC_FREQUENCY)
+        return find_response_times(tasks, num_tasks, relative_freq, find_job_overheads(num_tasks), NULL);
 
-        if (sum > tasks[i].period * relative_freq)
-        {
-            return 0;
-        }
+    return rm_test_task_set(tasks, num_tasks, relative_freq);
+}
+
+
+/*
+ * Pre-condition: The task-set and its static frequency.
+ * Post-condition: Prints the worst-case response time of every task at the static frequency (with the overheads of its jobs), and the slack margin left till its deadline.
+ */
+void
+print_static_slack_margins()
+{
+    float job_overheads = find_job_overheads(num_tasks);
+    float *response_times = (float *) malloc(sizeof(float) * num_tasks);
+    for (int i = 0; i < num_tasks; i++)
+        response_times[i] = -1;
+
+    int schedulable = find_response_times(tasks, num_tasks, static_freq_and_voltage.freq, job_overheads, response_times);
+    fprintf(output_file, "Slack margins at the static freq (every job is charged %0.3f units of overheads)%s:\n", job_overheads, schedulable ? "" : ". The task-set is not schedulable even at this freq");
+    for (int i = 0; i < num_tasks; i++)
+    {
+        if (response_times[i] < 0) // Not analysed, as a higher priority task already misses its deadline.
+            fprintf(output_file, "Task-%d: Deadline: %ld, Response time: not analysed\n", tasks[i].task_num, tasks[i].deadline);
+        else if (response_times[i] > tasks[i].deadline) // The analysis stops once the response time is past the deadline.
+            fprintf(output_file, "Task-%d: Deadline: %ld, Response time: more than %0.3f (misses its deadline)\n", tasks[i].task_num, tasks[i].deadline, response_times[i]);
+        else
+            fprintf(output_file, "Task-%d: Deadline: %ld, Response time: %0.3f, Slack margin: %0.3f (%0.1f%% of the deadline)\n", tasks[i].task_num, tasks[i].deadline, response_times[i], tasks[i].deadline - response_times[i], (tasks[i].deadline - response_times[i]) / tasks[i].deadline * 100);
     }
 
-    return 1;
+    free(response_times);
+
+    return;
 }
\ No newline at end of file
@@ -2,16 +2,31 @@ typedef struct
 {
     float freq; // Relative to Fmax.
     float voltage; // Absolute value of voltage.
+
+    // Power model of the level (precomputed when the inputs are read).
+    float dynamic_power; // Measured dynamic power, or v * v * f (with C = 1) if it is not given.
+    float static_power; // Measured static (leakage) power, or STATIC_POWER if it is not given.
 }
 Freq_and_voltage;
 
+typedef struct
+{
+    float energy; // Energy consumed by a change from one level to another.
+    float latency; // Time taken by the change.
+}
+Level_transition;
+
 // Functions.
 void input_sort_print_freq_and_voltage(); // Calls all the other functions related to initialising data.
 void input_freq_and_voltage(); // Inputs the data related to frequency and voltages.
 int sort_freq_and_voltage_comparator(); // The comparator used to compare two instances of Freq_and_voltage.
 void sort_freq_and_voltage(); // Used to sort the array containing the frequency and voltage data according to increasing order of frequency.
 void print_freq_and_voltage(); // Prints the array of structures containing the frequency and voltage data.
+void input_level_transitions(); // Inputs the optional transition energy and latency of pairs of levels.
+void find_level_transitions(); // Precomputes the transition energy and latency of every pair of levels.
+int find_freq_level(float); // Finds the index of the level with the given frequency in the sorted levels.
 void delete_freq_and_voltage(); // Deallocates and frees the memory allocated to array of structures containing the frequency and voltage data.
 
 void find_static_freq_and_voltage(); // Used to find the static frequency and voltage for the task-set.
-int rm_test(float); // Used to check whether a frequency passes the static frequency test or not.
\ No newline at end of file
+int rm_test(float); // Used to check whether a frequency passes the static frequency test or not.
+void print_static_slack_margins(); // Prints the response time and slack margin of every task at the static frequency.
\ No newline at end of file
@@ -0,0 +1,665 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "scheduler.h"
+#include "utility.h"
+#include "global_scheduler.h"
+#include "aet_source.h"
+#include "dpm.h"
+#include "histogram.h"
+#include "baseline.h"
+#include "report.h"
+#include "trace.h"
+
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
+extern _Thread_local long end_of_execution_time;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Level_transition *level_transitions;
+extern _Thread_local int static_freq_and_voltage_index;
+extern _Thread_local float total_dynamic_energy;
+extern unsigned long long simulation_seed;
+
+Global_core global_cores[NUM_CORES];
+
+// The shared ready queue is a binary heap of indices into the jobs array (highest priority at the root). Running jobs are not in it.
+int *global_ready_queue;
+int num_job_in_global_ready_queue;
+
+// The cores that run a job are kept in a binary heap of core indices with the lowest priority running job at the root, so that the job to preempt is found without scanning the cores.
+int running_cores[NUM_CORES];
+int num_running_cores;
+int running_core_positions[NUM_CORES]; // Position of every core in the heap (-1 when the core is idle).
+
+int *job_last_core; // Core on which every job last ran (-1 if it has not run yet).
+int next_job_to_release; // Index of the next job to arrive (the jobs array is sorted based on arrival time).
+double global_current_time;
+
+// Statistics of the whole cluster.
+long num_migrations;
+long num_cluster_freq_changes;
+int cluster_freq_and_voltage_index;
+extern _Thread_local long num_deadline_misses;
+
+
+/*
+ * Pre-condition: The sorted jobs and frequencies.
+ * Post-condition: Schedules the jobs on NUM_CORES cores with one shared ready queue and prints the schedule and its statistics.
+ */
+void
+start_global_scheduler()
+{
+    fprintf(output_file, "------------------------------------------------------------\n");
+    fprintf(output_file, "Global %s scheduling on %d cores with %s. (Scheduling from t=0 to t=%ld).\n\n", (GLOBAL_PRIORITY_POLICY == EDF_PRIORITY) ? "EDF" : "RM", NUM_CORES, CLUSTER_WIDE_DVFS ? "one cluster-wide frequency" : "per-core frequencies", end_of_execution_time);
+
+    // Setting the seed before random numbers are generated.
+    seed_random(simulation_seed);
+    init_aet_sources();
+    init_task_histograms();
+    trace_metadata(0, "Cluster");
+
+    // Initialising variables before the scheduler starts.
+    global_ready_queue = (int *) malloc(sizeof(int) * (num_jobs + 1));
+    num_job_in_global_ready_queue = 0;
+    job_last_core = (int *) malloc(sizeof(int) * (num_jobs + 1));
+    for (int i = 0; i < num_jobs; i++)
+        job_last_core[i] = -1;
+
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        global_cores[i].job_index = -1;
+        global_cores[i].prev_job_index = -1;
+        global_cores[i].prev_task = -1;
+        global_cores[i].freq_and_voltage_index = static_freq_and_voltage_index;
+        global_cores[i].overhead_left = 0;
+        global_cores[i].busy_time = 0;
+        global_cores[i].dynamic_energy = 0;
+        global_cores[i].num_context_switches = 0;
+        global_cores[i].num_preemptions = 0;
+        global_cores[i].num_cache_impact_points = 0;
+        global_cores[i].num_freq_changes = 0;
+        running_core_positions[i] = -1;
+    }
+    num_running_cores = 0;
+
+    next_job_to_release = 0;
+    global_current_time = 0;
+    num_migrations = 0;
+    num_cluster_freq_changes = 0;
+    cluster_freq_and_voltage_index = static_freq_and_voltage_index;
+    num_deadline_misses = 0;
+    total_dynamic_energy = 0;
+    for (int i = 0; i < NUM_CORES; i++)
+        trace_global_frequency(i);
+
+    // Starting the scheduler.
+    global_scheduler();
+
+    // Jobs that have not finished by the end of execution but whose deadline has passed have missed it as well.
+    for (int i = 0; i < num_jobs; i++)
+    {
+        if (jobs[i].alive && jobs[i].absolute_deadline <= end_of_execution_time)
+            num_deadline_misses++;
+    }
+
+    free(global_ready_queue);
+    free(job_last_core);
+
+    fprintf(output_file, "\n\nScheduler has finished scheduling.\n");
+    fprintf(output_file, "\nDisclaimer: Please open the statistics file to view the statistics of the execution of the task set.\n");
+    print_finished_jobs();
+    print_global_statistics();
+
+    // Print job-wise statistics.
+    capture_and_print_task_statistics();
+    print_task_histograms();
+    print_aet_statistics();
+    delete_aet_sources();
+
+    write_global_json_statistics();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: Initialised cores and shared ready queue.
+ * Post-condition: Schedules all the jobs till the end of execution. Every iteration handles one decision point (a job arrival or a job completion on any core).
+ */
+void
+global_scheduler()
+{
+    while (global_current_time < end_of_execution_time)
+    {
+        release_global_jobs();
+        dispatch_global_jobs();
+        select_global_frequencies();
+
+        // The next decision point is the next arrival or the next completion on any of the cores.
+        double next_decision_point = end_of_execution_time;
+        if (next_job_to_release < num_jobs && jobs[next_job_to_release].arrival_time < next_decision_point)
+            next_decision_point = jobs[next_job_to_release].arrival_time;
+
+        for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+        {
+            if (global_cores[i].job_index == -1)
+                continue;
+
+            double completion_time = global_current_time + global_cores[i].overhead_left + jobs[global_cores[i].job_index].time_left;
+            if (completion_time < next_decision_point)
+                next_decision_point = completion_time;
+        }
+
+        advance_global_cores(next_decision_point);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: Two jobs (indices into the jobs array).
+ * Post-condition: Returns 1 if the first job has a higher priority than the second one, 0 otherwise.
+ */
+int
+global_higher_priority(int a, int b)
+{
+    long period_a = tasks[jobs[a].sorted_task_num].period;
+    long period_b = tasks[jobs[b].sorted_task_num].period;
+
+    if (GLOBAL_PRIORITY_POLICY == EDF_PRIORITY)
+    {
+        if (jobs[a].absolute_deadline != jobs[b].absolute_deadline)
+            return jobs[a].absolute_deadline < jobs[b].absolute_deadline;
+        if (period_a != period_b)
+            return period_a < period_b;
+    }
+    else // RM.
+    {
+        if (period_a != period_b)
+            return period_a < period_b;
+        if (jobs[a].absolute_deadline != jobs[b].absolute_deadline)
+            return jobs[a].absolute_deadline < jobs[b].absolute_deadline;
+    }
+
+    return a < b;
+}
+
+
+/*
+ * Pre-condition: A job that is not in the shared ready queue.
+ * Post-condition: The job is added to the shared ready queue (sifted up in the heap).
+ */
+void
+push_global_ready_queue(int job_index)
+{
+    int i = num_job_in_global_ready_queue++;
+    while (i > 0 && global_higher_priority(job_index, global_ready_queue[(i - 1) / 2]))
+    {
+        global_ready_queue[i] = global_ready_queue[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    global_ready_queue[i] = job_index;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A non-empty shared ready queue.
+ * Post-condition: Removes and returns the highest priority job of the shared ready queue.
+ */
+int
+pop_global_ready_queue()
+{
+    int top = global_ready_queue[0];
+    int last = global_ready_queue[--num_job_in_global_ready_queue];
+
+    // Sifting the last job down from the root.
+    int i = 0;
+    while (2 * i + 1 < num_job_in_global_ready_queue)
+    {
+        int child = 2 * i + 1;
+        if (child + 1 < num_job_in_global_ready_queue && global_higher_priority(global_ready_queue[child + 1], global_ready_queue[child]))
+            child++;
+        if (!global_higher_priority(global_ready_queue[child], last))
+            break;
+
+        global_ready_queue[i] = global_ready_queue[child];
+        i = child;
+    }
+    if (num_job_in_global_ready_queue > 0)
+        global_ready_queue[i] = last;
+
+    return top;
+}
+
+
+/*
+ * Pre-condition: The next decision point, which is not after the completion of any running job.
+ * Post-condition: Every core runs its job (after its pending overheads) till the given time. Jobs that finish are completed and the time moves to the given time.
+ */
+void
+advance_global_cores(double time)
+{
+    double elapsed = time - global_current_time;
+
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        Global_core *core = &global_cores[i];
+        if (core->job_index == -1) // Idle cores do not consume dynamic energy.
+            continue;
+
+        Job *job = &jobs[core->job_index];
+
+        // Overheads are spent first, then the job executes.
+        float overhead = (core->overhead_left < elapsed) ? core->overhead_left : elapsed;
+        float execution_time = elapsed - overhead;
+        core->overhead_left -= overhead;
+        job->time_left -= execution_time;
+        job->time_executed += execution_time;
+
+        // Dynamic energy = dynamic power of the level * time (as on one core).
+        float dynamic_energy = freq_and_voltage[core->freq_and_voltage_index].dynamic_power * elapsed;
+        core->dynamic_energy += dynamic_energy;
+        core->busy_time += elapsed;
+        job->dynamic_energy_consumed += dynamic_energy;
+        total_dynamic_energy += dynamic_energy;
+        trace_job_slice(TRACE_TASK_TID(job->task_num), job, time - execution_time, time, freq_and_voltage[core->freq_and_voltage_index].freq);
+
+        if (job->time_left <= 1e-5) // The job has finished.
+        {
+            job->time_left = 0;
+            job->alive = false;
+            job->finish_time = time;
+            job->execution_freq_index = core->freq_and_voltage_index;
+
+            if (time > job->absolute_deadline)
+            {
+                num_deadline_misses++;
+                fprintf(output_file, "Job J%d,%d missed its deadline at t=%ld.\n", job->task_num, job->instance_num, job->absolute_deadline);
+
+                char name[64];
+                snprintf(name, sizeof(name), "J%d,%d missed its deadline", job->task_num, job->instance_num);
+                trace_instant(TRACE_TASK_TID(job->task_num), name, job->absolute_deadline);
+            }
+            fprintf(output_file, "Job J%d,%d: Finished execution on core %d at t=%0.2f. Dynamic energy consumed: %0.2f.\n", job->task_num, job->instance_num, i, time, job->dynamic_energy_consumed);
+            add_job_histograms(job->sorted_task_num, time - job->arrival_time, time - job->arrival_time - job->time_executed, time - job->absolute_deadline);
+
+            remove_running_core(i);
+            core->job_index = -1;
+        }
+    }
+
+    global_current_time = time;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The jobs array sorted based on arrival time.
+ * Post-condition: All the jobs that have arrived till the current time are added to the shared ready queue with their actual execution times.
+ */
+void
+release_global_jobs()
+{
+    while (next_job_to_release < num_jobs && jobs[next_job_to_release].arrival_time <= global_current_time)
+    {
+        Job *job = &jobs[next_job_to_release];
+
+        // Actual execution time from the model of the task (as on one core).
+        float aet = find_actual_execution_time(job->sorted_task_num, job->wcet);
+        job->aet = aet;
+        job->time_left = aet;
+        job->time_executed = 0;
+        job->admitted = true;
+
+        fprintf(output_file, "Job J%d,%d: Added to the ready queue at t=%0.2f. Execution time left to finish: %0.2f\n", job->task_num, job->instance_num, global_current_time, aet);
+
+        push_global_ready_queue(next_job_to_release);
+        next_job_to_release++;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The shared ready queue and the cores.
+ * Post-condition: The cores run the (at most) NUM_CORES highest priority jobs. Idle cores are filled first, then the lowest priority running jobs are preempted.
+ */
+void
+dispatch_global_jobs()
+{
+    // Filling the idle cores. A job goes back to the core it last ran on if that core is idle.
+    for (int i = 0; i < NUM_CORES && num_job_in_global_ready_queue > 0; i++)
+    {
+        if (global_cores[i].job_index != -1)
+            continue;
+
+        int job_index = pop_global_ready_queue();
+        int core = i;
+        if (job_last_core[job_index] != -1 && global_cores[job_last_core[job_index]].job_index == -1)
+            core = job_last_core[job_index];
+
+        assign_global_core(core, job_index);
+
+        if (core != i) // Core i is still idle.
+            i--;
+    }
+
+    // Preempting the lowest priority running jobs (at the root of the heap of running cores) as long as a ready job has a higher priority. At most NUM_CORES preemptions happen.
+    while (num_job_in_global_ready_queue > 0 && num_running_cores > 0)
+    {
+        int lowest_core = running_cores[0];
+        if (!global_higher_priority(global_ready_queue[0], global_cores[lowest_core].job_index))
+            break;
+
+        Job preempted_job = jobs[global_cores[lowest_core].job_index];
+        fprintf(output_file, "Job J%d,%d was preempted on core %d at t=%0.2f. Preemption overhead: %0.2f\n", preempted_job.task_num, preempted_job.instance_num, lowest_core, global_current_time, PREEMPTION_OVERHEAD);
+
+        char name[64];
+        snprintf(name, sizeof(name), "J%d,%d preempted", preempted_job.task_num, preempted_job.instance_num);
+        trace_instant(TRACE_TASK_TID(preempted_job.task_num), name, global_current_time);
+        push_global_ready_queue(global_cores[lowest_core].job_index);
+        remove_running_core(lowest_core);
+        global_cores[lowest_core].job_index = -1;
+        global_cores[lowest_core].num_preemptions++;
+        global_cores[lowest_core].overhead_left += PREEMPTION_OVERHEAD;
+
+        assign_global_core(lowest_core, pop_global_ready_queue());
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An idle core and a job that is not running.
+ * Post-condition: The job runs on the core. Context switches, cache impact points and migrations are counted.
+ */
+void
+assign_global_core(int core_index, int job_index)
+{
+    Global_core *core = &global_cores[core_index];
+    Job job = jobs[job_index];
+
+    // Same definitions as on one core.
+    if (core->prev_job_index != -1 && core->prev_job_index != job_index)
+        core->num_context_switches++;
+    if (core->prev_task != job.task_num)
+        core->num_cache_impact_points++;
+
+    // A migration is when a job resumes on a different core than the one it was preempted on.
+    if (job_last_core[job_index] != -1 && job_last_core[job_index] != core_index)
+    {
+        num_migrations++;
+        fprintf(output_file, "Job J%d,%d migrated from core %d to core %d at t=%0.2f.\n", job.task_num, job.instance_num, job_last_core[job_index], core_index, global_current_time);
+
+        char name[64];
+        snprintf(name, sizeof(name), "J%d,%d migrated to core %d", job.task_num, job.instance_num, core_index);
+        trace_instant(TRACE_TASK_TID(job.task_num), name, global_current_time);
+    }
+
+    core->job_index = job_index;
+    add_running_core(core_index);
+    core->prev_job_index = job_index;
+    core->prev_task = job.task_num;
+    job_last_core[job_index] = core_index;
+
+    fprintf(output_file, "Job J%d,%d: Running on core %d from t=%0.2f.\n", job.task_num, job.instance_num, core_index, global_current_time);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A position in the heap of running cores.
+ * Post-condition: The core at the position is sifted up or down till the job of every core has a lower priority than the jobs of its children.
+ */
+void
+sift_running_core(int position)
+{
+    int core = running_cores[position];
+
+    // Sifting up while the parent runs a higher priority job.
+    while (position > 0 && global_higher_priority(global_cores[running_cores[(position - 1) / 2]].job_index, global_cores[core].job_index))
+    {
+        running_cores[position] = running_cores[(position - 1) / 2];
+        running_core_positions[running_cores[position]] = position;
+        position = (position - 1) / 2;
+    }
+
+    // Sifting down while a child runs a lower priority job.
+    while (2 * position + 1 < num_running_cores)
+    {
+        int child = 2 * position + 1;
+        if (child + 1 < num_running_cores && global_higher_priority(global_cores[running_cores[child]].job_index, global_cores[running_cores[child + 1]].job_index))
+            child++;
+        if (!global_higher_priority(global_cores[core].job_index, global_cores[running_cores[child]].job_index))
+            break;
+
+        running_cores[position] = running_cores[child];
+        running_core_positions[running_cores[position]] = position;
+        position = child;
+    }
+
+    running_cores[position] = core;
+    running_core_positions[core] = position;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A core that has just started running a job.
+ * Post-condition: The core is added to the heap of running cores.
+ */
+void
+add_running_core(int core_index)
+{
+    running_cores[num_running_cores] = core_index;
+    sift_running_core(num_running_cores++);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A core in the heap of running cores (whose job is still set).
+ * Post-condition: The core is removed from the heap (the last core takes its place and is sifted).
+ */
+void
+remove_running_core(int core_index)
+{
+    int position = running_core_positions[core_index];
+    running_core_positions[core_index] = -1;
+
+    int last = running_cores[--num_running_cores];
+    if (position < num_running_cores)
+    {
+        running_cores[position] = last;
+        sift_running_core(position);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The jobs running on the cores.
+ * Post-condition: Every core runs at the lowest level that lets its job finish by its deadline (or, with cluster-wide DVFS, all cores run at the highest of these levels). Frequency changes add the frequency change overhead.
+ */
+void
+select_global_frequencies()
+{
+    int levels[NUM_CORES];
+    int cluster_level = 0;
+
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        levels[i] = global_cores[i].freq_and_voltage_index;
+        if (global_cores[i].job_index == -1)
+            continue;
+
+        // The utilisation that the job needs till its deadline.
+        Job job = jobs[global_cores[i].job_index];
+        double time_till_deadline = job.absolute_deadline - global_current_time;
+        float utilisation = (time_till_deadline > 0) ? job.time_left / time_till_deadline : 1;
+
+        levels[i] = find_level_for_utilisation(utilisation);
+        if (levels[i] > cluster_level)
+            cluster_level = levels[i];
+    }
+
+    if (CLUSTER_WIDE_DVFS)
+    {
+        if (cluster_level == cluster_freq_and_voltage_index)
+            return;
+
+        fprintf(output_file, "Cluster frequency change at t=%0.2f. New frequency: %0.2f\n", global_current_time, freq_and_voltage[cluster_level].freq);
+        cluster_freq_and_voltage_index = cluster_level;
+        num_cluster_freq_changes++;
+
+        for (int i = 0; i < NUM_CORES; i++)
+            levels[i] = cluster_level;
+    }
+
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        if (levels[i] == global_cores[i].freq_and_voltage_index)
+            continue;
+
+        float latency = level_transitions[global_cores[i].freq_and_voltage_index * num_freq_levels + levels[i]].latency;
+        global_cores[i].freq_and_voltage_index = levels[i];
+        global_cores[i].num_freq_changes++;
+        trace_global_frequency(i);
+
+        // Only a busy core has to wait for the change. An idle core changes in the background.
+        if (global_cores[i].job_index != -1)
+            global_cores[i].overhead_left += latency;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A core whose frequency level has just been set.
+ * Post-condition: The frequency counter track of the core is updated (if the schedule is traced).
+ */
+void
+trace_global_frequency(int core_index)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "Core %d frequency", core_index);
+    trace_counter(name, global_current_time, freq_and_voltage[global_cores[core_index].freq_and_voltage_index].freq);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted frequencies and a utilisation.
+ * Post-condition: The index of the lowest frequency that is at least the utilisation (the highest frequency if there is none).
+ */
+int
+find_level_for_utilisation(float utilisation)
+{
+    int low = 0, high = num_freq_levels - 1;
+
+    // Binary search for the first frequency >= utilisation.
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (freq_and_voltage[mid].freq >= utilisation)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    return low;
+}
+
+
+/*
+ * Pre-condition: The statistics of the cores after the schedule.
+ * Post-condition: Prints the statistics of every core and of the whole cluster onto the statistics file.
+ */
+void
+print_global_statistics()
+{
+    long total_context_switches = 0, total_preemptions = 0, total_cache_impact_points = 0, total_freq_changes = 0;
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Global %s scheduling on %d cores with %s.\n", (GLOBAL_PRIORITY_POLICY == EDF_PRIORITY) ? "EDF" : "RM", NUM_CORES, CLUSTER_WIDE_DVFS ? "one cluster-wide frequency" : "per-core frequencies");
+    fprintf(statistics_file, "Disclaimer: A migration is when a job resumes on a different core than the one it last ran on.\n");
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        Global_core core = global_cores[i];
+        fprintf(statistics_file, "Core %d: Busy time: %0.2f, Dynamic energy: %0.2f, Context-switches: %ld, Preemptions: %ld, Cache-impact points: %ld, Frequency changes: %ld\n", i, core.busy_time, core.dynamic_energy, core.num_context_switches, core.num_preemptions, core.num_cache_impact_points, core.num_freq_changes);
+
+        total_context_switches += core.num_context_switches;
+        total_preemptions += core.num_preemptions;
+        total_cache_impact_points += core.num_cache_impact_points;
+        total_freq_changes += core.num_freq_changes;
+    }
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Random seed: %llu\n", simulation_seed);
+    fprintf(statistics_file, "Total dynamic-energy consumer: %0.2f\n", total_dynamic_energy);
+    fprintf(statistics_file, "Weighted average percentage of execution of jobs: %0.1f\n", find_avg_percentage_execution());
+    fprintf(statistics_file, "Total number of context-switches: %ld\n", total_context_switches);
+    fprintf(statistics_file, "Total number of preemptions: %ld\n", total_preemptions);
+    fprintf(statistics_file, "Total number of migrations: %ld\n", num_migrations);
+    fprintf(statistics_file, "Total number of cache-impact points: %ld\n", total_cache_impact_points);
+    if (CLUSTER_WIDE_DVFS)
+        fprintf(statistics_file, "Total number of cluster frequency changes: %ld\n", num_cluster_freq_changes);
+    else
+        fprintf(statistics_file, "Total number of frequency changes: %ld\n", total_freq_changes);
+    fprintf(statistics_file, "Total number of deadline misses: %ld\n", num_deadline_misses);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The statistics of every core and of the whole cluster after the scheduler has finished.
+ * Post-condition: Writes the totals of the cluster and the histograms of the tasks onto the machine-readable statistics file.
+ */
+void
+write_global_json_statistics()
+{
+    Simulation_summary summary = {0};
+
+    summary.total_dynamic_energy = total_dynamic_energy;
+    summary.total_energy = find_total_energy();
+    summary.num_freq_changes = CLUSTER_WIDE_DVFS ? num_cluster_freq_changes : 0;
+    summary.num_deadline_misses = num_deadline_misses;
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        summary.num_context_switches += global_cores[i].num_context_switches;
+        summary.num_preemptions += global_cores[i].num_preemptions;
+        if (!CLUSTER_WIDE_DVFS)
+            summary.num_freq_changes += global_cores[i].num_freq_changes;
+    }
+    for (int i = 0; i < num_jobs; i++)
+    {
+        if (jobs[i].alive == false)
+            summary.num_finished_jobs++;
+    }
+
+    write_json_statistics(&summary, simulation_seed, global_current_time);
+
+    return;
+}
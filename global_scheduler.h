@@ -0,0 +1,38 @@
+typedef struct
+{
+    // Job running on the core (-1 when the core is idle) and the last job and task that ran on it.
+    int job_index;
+    int prev_job_index;
+    int prev_task;
+
+    int freq_and_voltage_index;
+    float overhead_left; // Overhead (preemption and frequency change) to be spent before the running job continues.
+
+    // Statistics of the core.
+    float busy_time;
+    float dynamic_energy;
+    long num_context_switches;
+    long num_preemptions;
+    long num_cache_impact_points;
+    long num_freq_changes;
+}
+Global_core;
+
+// Functions.
+void start_global_scheduler(); // Initialises and runs the global multicore scheduler and prints its statistics.
+void global_scheduler(); // Schedules the jobs from one shared ready queue onto all the cores.
+int global_higher_priority(int, int); // Compares the priority of two jobs under global RM or global EDF.
+void push_global_ready_queue(int); // Adds a job to the shared ready queue (a binary heap).
+int pop_global_ready_queue(); // Removes the highest priority job from the shared ready queue.
+void advance_global_cores(double); // Runs every core from the current time to the given time.
+void release_global_jobs(); // Adds all the jobs that have arrived to the shared ready queue.
+void dispatch_global_jobs(); // Fills idle cores and preempts lower priority jobs with the highest priority ready jobs.
+void assign_global_core(int, int); // Starts (or resumes) a job on a core.
+void sift_running_core(int); // Restores the order of the heap of running cores at a position.
+void add_running_core(int); // Adds a core that runs a job to the heap of running cores.
+void remove_running_core(int); // Removes a core from the heap of running cores.
+void select_global_frequencies(); // Selects the frequency of every core (or of the whole cluster).
+void trace_global_frequency(int); // Writes the frequency of a core onto its counter track.
+int find_level_for_utilisation(float); // The lowest frequency level that is at least the given utilisation.
+void print_global_statistics(); // Prints the per-core and total statistics of the global multicore schedule.
+void write_global_json_statistics(); // Writes the totals of the cluster and the histograms of the tasks as machine-readable statistics.
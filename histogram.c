@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "histogram.h"
+
+// Global variables required to keep the histograms of the tasks.
+
+// Output files.
+extern _Thread_local FILE *statistics_file;
+
+// Tasks.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+
+// Histograms of every task (sorted based on period), indexed by (sorted task number * NUM_TASK_HISTOGRAMS + kind of histogram).
+_Thread_local Histogram *task_histograms;
+
+static const char *const task_histogram_names[NUM_TASK_HISTOGRAMS] = {"Response time", "Waiting time", "Lateness"};
+
+
+/*
+ * Pre-condition: A histogram.
+ * Post-condition: The histogram has no values.
+ */
+void
+init_histogram(Histogram *histogram)
+{
+    for (int i = 0; i < HISTOGRAM_NUM_BUCKETS; i++)
+        histogram->counts[i] = 0;
+    histogram->num_values = 0;
+    histogram->sum = 0;
+    histogram->min = FLT_MAX;
+    histogram->max = -FLT_MAX;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A value.
+ * Post-condition: Returns the bucket of the value.
+ *
+ * The magnitude m = HISTOGRAM_MIN_VALUE * 2^octave * (1 + sub-bucket / HISTOGRAM_SUB_BUCKETS), where frexp() gives the octave and the fraction without a logarithm.
+ */
+int
+find_histogram_bucket(float value)
+{
+    double magnitude = fabs(value) / HISTOGRAM_MIN_VALUE;
+    if (magnitude < 1)
+        return HISTOGRAM_ZERO_BUCKET;
+
+    int exponent;
+    double fraction = frexp(magnitude, &exponent); // magnitude = fraction * 2^exponent, with fraction in [0.5, 1).
+    int octave = exponent - 1;
+    int sub_bucket = (int) ((fraction * 2 - 1) * HISTOGRAM_SUB_BUCKETS);
+
+    int magnitude_bucket = octave * HISTOGRAM_SUB_BUCKETS + sub_bucket;
+    if (magnitude_bucket >= HISTOGRAM_NUM_MAGNITUDE_BUCKETS)
+        magnitude_bucket = HISTOGRAM_NUM_MAGNITUDE_BUCKETS - 1;
+
+    return (value > 0) ? HISTOGRAM_ZERO_BUCKET + 1 + magnitude_bucket : HISTOGRAM_ZERO_BUCKET - 1 - magnitude_bucket;
+}
+
+
+/*
+ * Pre-condition: A bucket.
+ * Post-condition: Returns the middle of the range of values of the bucket.
+ */
+float
+find_histogram_bucket_value(int bucket)
+{
+    if (bucket == HISTOGRAM_ZERO_BUCKET)
+        return 0;
+
+    int magnitude_bucket = (bucket > HISTOGRAM_ZERO_BUCKET) ? bucket - HISTOGRAM_ZERO_BUCKET - 1 : HISTOGRAM_ZERO_BUCKET - 1 - bucket;
+    int octave = magnitude_bucket / HISTOGRAM_SUB_BUCKETS;
+    int sub_bucket = magnitude_bucket % HISTOGRAM_SUB_BUCKETS;
+    float magnitude = HISTOGRAM_MIN_VALUE * ldexp(1 + (sub_bucket + 0.5) / HISTOGRAM_SUB_BUCKETS, octave);
+
+    return (bucket > HISTOGRAM_ZERO_BUCKET) ? magnitude : -magnitude;
+}
+
+
+/*
+ * Pre-condition: A histogram and a value.
+ * Post-condition: The value is counted in its bucket.
+ */
+void
+add_histogram_value(Histogram *histogram, float value)
+{
+    histogram->counts[find_histogram_bucket(value)]++;
+    histogram->num_values++;
+    histogram->sum += value;
+    if (value < histogram->min)
+        histogram->min = value;
+    if (value > histogram->max)
+        histogram->max = value;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: Two histograms (for example, of the same task in two runs or of two tasks on different cores).
+ * Post-condition: The first histogram also counts all the values of the second one.
+ */
+void
+merge_histograms(Histogram *histogram, const Histogram *other)
+{
+    for (int i = 0; i < HISTOGRAM_NUM_BUCKETS; i++)
+        histogram->counts[i] += other->counts[i];
+    histogram->num_values += other->num_values;
+    histogram->sum += other->sum;
+    if (other->min < histogram->min)
+        histogram->min = other->min;
+    if (other->max > histogram->max)
+        histogram->max = other->max;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A histogram and a percentage (0 to 100).
+ * Post-condition: Returns the value of the bucket in which the given percentage of the values is reached (within the smallest and largest values seen).
+ */
+float
+find_histogram_percentile(const Histogram *histogram, float percentage)
+{
+    if (histogram->num_values == 0)
+        return 0;
+
+    // The rank of the value, counting from 1.
+    long rank = (long) ceil(percentage / 100 * histogram->num_values);
+    if (rank < 1)
+        rank = 1;
+
+    long count = 0;
+    for (int i = 0; i < HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        count += histogram->counts[i];
+        if (count >= rank)
+        {
+            float value = find_histogram_bucket_value(i);
+            if (value < histogram->min)
+                value = histogram->min;
+            if (value > histogram->max)
+                value = histogram->max;
+            return value;
+        }
+    }
+
+    return histogram->max;
+}
+
+
+/*
+ * Pre-condition: An open file and a histogram.
+ * Post-condition: Prints the count, mean, P50, P90, P99, P99.9 and the extremes of the histogram on one line.
+ */
+void
+print_histogram_percentiles(FILE *file, const Histogram *histogram)
+{
+    if (histogram->num_values == 0)
+    {
+        fprintf(file, "ND\n");
+        return;
+    }
+
+    fprintf(file, "Count: %ld, Mean: %0.3f, P50: %0.3f, P90: %0.3f, P99: %0.3f, P99.9: %0.3f, Min: %0.3f, Max: %0.3f\n", histogram->num_values, histogram->sum / histogram->num_values, find_histogram_percentile(histogram, 50), find_histogram_percentile(histogram, 90), find_histogram_percentile(histogram, 99), find_histogram_percentile(histogram, 99.9), histogram->min, histogram->max);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An open file and a histogram.
+ * Post-condition: Writes the histogram as a JSON object. The non-empty buckets are written as [bucket, count] pairs, so that histograms of other runs can be merged.
+ */
+void
+write_histogram_json(FILE *file, const Histogram *histogram)
+{
+    fprintf(file, "{\"count\": %ld", histogram->num_values);
+    if (histogram->num_values > 0)
+    {
+        fprintf(file, ", \"mean\": %g, \"min\": %g, \"max\": %g", histogram->sum / histogram->num_values, histogram->min, histogram->max);
+        fprintf(file, ", \"p50\": %g, \"p90\": %g, \"p99\": %g, \"p999\": %g", find_histogram_percentile(histogram, 50), find_histogram_percentile(histogram, 90), find_histogram_percentile(histogram, 99), find_histogram_percentile(histogram, 99.9));
+    }
+
+    fprintf(file, ", \"buckets\": [");
+    int first = 1;
+    for (int i = 0; i < HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        if (histogram->counts[i] == 0)
+            continue;
+
+        fprintf(file, "%s[%d, %ld]", first ? "" : ", ", i - HISTOGRAM_ZERO_BUCKET, histogram->counts[i]);
+        first = 0;
+    }
+    fprintf(file, "]}");
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task-set.
+ * Post-condition: Empty histograms for every task.
+ */
+void
+init_task_histograms()
+{
+    task_histograms = (Histogram *) malloc(sizeof(Histogram) * num_tasks * NUM_TASK_HISTOGRAMS);
+    for (int i = 0; i < num_tasks * NUM_TASK_HISTOGRAMS; i++)
+        init_histogram(&task_histograms[i]);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task number of a job that just finished, with its response time, waiting time and lateness.
+ * Post-condition: The values are added to the histograms of the task.
+ */
+void
+add_job_histograms(int sorted_task_num, float response_time, float waiting_time, float lateness)
+{
+    Histogram *histograms = &task_histograms[sorted_task_num * NUM_TASK_HISTOGRAMS];
+    add_histogram_value(&histograms[RESPONSE_TIME_HISTOGRAM], response_time);
+    add_histogram_value(&histograms[WAITING_TIME_HISTOGRAM], waiting_time);
+    add_histogram_value(&histograms[LATENESS_HISTOGRAM], lateness);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The histograms of the tasks after the scheduler has finished.
+ * Post-condition: Prints the percentiles of every task, and of all the tasks together, onto the statistics file.
+ */
+void
+print_task_histograms()
+{
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Percentile statistics (log-bucketed histograms, within %0.1f%% of the value):\n", 100.0 / HISTOGRAM_SUB_BUCKETS);
+
+    for (int k = 0; k < NUM_TASK_HISTOGRAMS; k++) // Iterating through each kind of histogram.
+    {
+        Histogram all_tasks;
+        init_histogram(&all_tasks);
+
+        fprintf(statistics_file, "%s:\n", task_histogram_names[k]);
+        for (int i = 0; i < num_tasks; i++)
+        {
+            fprintf(statistics_file, "Task-%d: ", tasks[i].task_num);
+            print_histogram_percentiles(statistics_file, &task_histograms[i * NUM_TASK_HISTOGRAMS + k]);
+            merge_histograms(&all_tasks, &task_histograms[i * NUM_TASK_HISTOGRAMS + k]);
+        }
+        fprintf(statistics_file, "All tasks: ");
+        print_histogram_percentiles(statistics_file, &all_tasks);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The histograms of the tasks.
+ * Post-condition: Frees the histograms.
+ */
+void
+delete_task_histograms()
+{
+    free(task_histograms);
+    task_histograms = NULL;
+
+    return;
+}
@@ -0,0 +1,39 @@
+// Parameters of the log-bucketed histograms. Every octave of values (from HISTOGRAM_MIN_VALUE) is split into HISTOGRAM_SUB_BUCKETS buckets, so a percentile is within 1/HISTOGRAM_SUB_BUCKETS of the value.
+#define HISTOGRAM_MIN_VALUE 0.001 // Magnitudes below this go into the zero bucket.
+#define HISTOGRAM_SUB_BUCKETS 16
+#define HISTOGRAM_NUM_OCTAVES 32
+#define HISTOGRAM_NUM_MAGNITUDE_BUCKETS (HISTOGRAM_SUB_BUCKETS * HISTOGRAM_NUM_OCTAVES)
+#define HISTOGRAM_NUM_BUCKETS (2 * HISTOGRAM_NUM_MAGNITUDE_BUCKETS + 1) // Negative values, zero and positive values.
+#define HISTOGRAM_ZERO_BUCKET HISTOGRAM_NUM_MAGNITUDE_BUCKETS
+
+// Fixed-memory histogram of (possibly negative) values. Two histograms with the same parameters are merged by adding their buckets.
+typedef struct
+{
+    long counts[HISTOGRAM_NUM_BUCKETS];
+    long num_values;
+    double sum;
+    float min;
+    float max;
+}
+Histogram;
+
+// Kinds of values whose histograms are kept for every task.
+#define RESPONSE_TIME_HISTOGRAM 0
+#define WAITING_TIME_HISTOGRAM 1
+#define LATENESS_HISTOGRAM 2
+#define NUM_TASK_HISTOGRAMS 3
+
+// Functions.
+void init_histogram(Histogram *); // Empties a histogram.
+int find_histogram_bucket(float); // The bucket of a value.
+float find_histogram_bucket_value(int); // The representative value of a bucket.
+void add_histogram_value(Histogram *, float); // Adds a value to a histogram.
+void merge_histograms(Histogram *, const Histogram *); // Adds all the values of the second histogram to the first one.
+float find_histogram_percentile(const Histogram *, float); // The value below which the given percentage of the values lie.
+void print_histogram_percentiles(FILE *, const Histogram *); // Prints the count, mean, percentiles and extremes of a histogram.
+void write_histogram_json(FILE *, const Histogram *); // Writes a histogram (along with its non-empty buckets) as a JSON object.
+
+void init_task_histograms(); // Allocates empty histograms for every task.
+void add_job_histograms(int, float, float, float); // Adds the response time, waiting time and lateness of a finished job to the histograms of its task.
+void print_task_histograms(); // Prints the percentiles of every task (and of all the tasks together).
+void delete_task_histograms(); // Frees the histograms of the tasks.
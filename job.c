@@ -5,13 +5,13 @@
 #include "job.h"
 #include "task.h"
 
-extern FILE *output_file;
+extern _Thread_local FILE *output_file;
 
-extern int num_tasks;
-extern Task *tasks;
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
 
-extern int num_jobs;
-extern Job *jobs;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
 
 
 /*
@@ -81,12 +81,14 @@ create_jobs()
 
             jobs[index].alive = true;
             jobs[index].admitted = false;
+            jobs[index].aborted = false;
             jobs[index].time_executed = 0;
 
             jobs[index].execution_freq_index = -1;
             jobs[index].dynamic_energy_consumed = 0;
 
             jobs[index].aet = -1;
+            jobs[index].predicted_time = task.wcet;
             jobs[index].finish_time = -1;
 
             index++;
@@ -141,6 +143,10 @@ sort_jobs()
 {
     qsort((void *) jobs, num_jobs, sizeof(jobs[0]), sort_jobs_comparator);
 
+    // Jobs in the ready queue are copies, so they remember where they came from in the sorted array.
+    for (int i = 0; i < num_jobs; i++)
+        jobs[i].job_index = i;
+
     return;
 }
 
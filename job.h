@@ -6,11 +6,13 @@ typedef struct
     int task_num; // Task number corresponding to the task-num of the task.
     int sorted_task_num; // Index of the task in the task-array which is sorted based on period (because of sorting, sorted_task_num need to be equal to task_num).
     int instance_num;
+    int job_index; // Index of the job in the jobs array (which is sorted based on arrival time).
 
     // Timing characteristics of the job.
     long arrival_time;
     float wcet; // Worst-case execution time.
     float aet; // Actual execution time.
+    float predicted_time; // Execution time predicted at the release of the job (used only with AET_PREDICTION).
     float time_executed; // Total amount of time the job has executed for so far.
     float time_next_execution; // Time alloted till next deadline.
     float time_left; // Time left in overall execution. Will be 0 when job has finished executing.
@@ -24,6 +26,7 @@ typedef struct
     // To find whether a job has completed or has already been accepted.
     bool alive;
     bool admitted;
+    bool aborted; // Aborted at its deadline (or skipped) by the overrun policy.
 }
 Job;
 
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "parser.h"
+#include "freq_and_voltage.h"
+#include "overhead.h"
+
+// Global variables required to find the overheads of a decision point.
+
+extern _Thread_local FILE *output_file;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Level_transition *level_transitions;
+
+// Measured overheads (sorted based on the number of ready jobs). Like the other inputs, they are only read by the main thread.
+int num_overhead_entries;
+Overhead_entry *overhead_table;
+
+
+/*
+ * Pre-condition: None.
+ * Post-condition: The measured overheads are read (if the overhead model is a table), and the model is printed.
+ */
+void
+init_overhead_model()
+{
+    if (OVERHEAD_MODEL == OVERHEAD_TABLE)
+        input_overhead_table();
+
+    print_overhead_model();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An input file with the number of entries followed by the number of ready jobs, the decision making overhead and the frequency calculation overhead (one entry per line).
+ * Post-condition: The measured overheads, sorted based on the number of ready jobs.
+ */
+void
+input_overhead_table()
+{
+    Input_file input_overhead_file;
+    open_input_file(&input_overhead_file, INPUT_OVERHEAD_FILE_NAME);
+
+    long num_entries_input;
+    if (!scan_long(&input_overhead_file, &num_entries_input) || num_entries_input <= 0)
+        parse_error(&input_overhead_file, input_overhead_file.line, "Invalid number of measured overheads");
+
+    num_overhead_entries = num_entries_input;
+    overhead_table = (Overhead_entry *) malloc(sizeof(Overhead_entry) * num_overhead_entries);
+    for (int i = 0; i < num_overhead_entries; i++) // Iterates over all the entries.
+    {
+        // Every entry is on its own line.
+        skip_whitespace(&input_overhead_file);
+        int line = input_overhead_file.line;
+
+        long num_ready_jobs;
+        if (!scan_long(&input_overhead_file, &num_ready_jobs) || !scan_float(&input_overhead_file, &overhead_table[i].decision_making_overhead) || !scan_float(&input_overhead_file, &overhead_table[i].frequency_calculation_overhead))
+            parse_error(&input_overhead_file, line, "Expected the number of ready jobs, the decision making overhead and the frequency calculation overhead");
+
+        if (input_overhead_file.line != line || !end_of_line(&input_overhead_file))
+            parse_error(&input_overhead_file, line, "A measured overhead has to be given on one line");
+
+        if (num_ready_jobs < 0 || (i > 0 && num_ready_jobs <= overhead_table[i - 1].num_ready_jobs) || overhead_table[i].decision_making_overhead < 0 || overhead_table[i].frequency_calculation_overhead < 0)
+            parse_error(&input_overhead_file, line, "The overheads have to be positive and given for an increasing number of ready jobs");
+
+        overhead_table[i].num_ready_jobs = num_ready_jobs;
+    }
+
+    close_input_file(&input_overhead_file);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The measured overheads, the kind of overhead (0 = decision making, 1 = frequency calculation) and the number of ready jobs.
+ * Post-condition: The overhead interpolated between the measurements around the number of ready jobs.
+ *
+ * Beyond the measurements, the overhead keeps growing at the rate of the last two of them (and stays at the first one below them), so that a larger task-set is never cheaper than the measured ones.
+ */
+float
+find_table_overhead(int kind, int num_ready_jobs)
+{
+    int i = 0;
+    while (i < num_overhead_entries - 2 && overhead_table[i + 1].num_ready_jobs < num_ready_jobs)
+        i++;
+
+    float first = (kind == 0) ? overhead_table[i].decision_making_overhead : overhead_table[i].frequency_calculation_overhead;
+    if (num_overhead_entries == 1 || num_ready_jobs <= overhead_table[i].num_ready_jobs)
+        return first;
+
+    float second = (kind == 0) ? overhead_table[i + 1].decision_making_overhead : overhead_table[i + 1].frequency_calculation_overhead;
+    float overhead = first + (second - first) * (num_ready_jobs - overhead_table[i].num_ready_jobs) / (overhead_table[i + 1].num_ready_jobs - overhead_table[i].num_ready_jobs);
+
+    return (overhead > 0) ? overhead : 0;
+}
+
+
+/*
+ * Pre-condition: The number of jobs in the ready queue at a decision point.
+ * Post-condition: The time taken to decide which job runs next (the CC-RM loop walks every ready job).
+ */
+float
+find_decision_making_overhead(int num_ready_jobs)
+{
+    if (OVERHEAD_MODEL == OVERHEAD_LINEAR)
+        return DECISION_MAKING_OVERHEAD + DECISION_MAKING_OVERHEAD_PER_JOB * num_ready_jobs;
+    else if (OVERHEAD_MODEL == OVERHEAD_TABLE)
+        return find_table_overhead(0, num_ready_jobs);
+
+    return DECISION_MAKING_OVERHEAD;
+}
+
+
+/*
+ * Pre-condition: The number of jobs in the ready queue at a decision point.
+ * Post-condition: The time taken to select the frequency (the dynamic utilisation is summed over the ready jobs and compared against every level).
+ */
+float
+find_frequency_calculation_overhead(int num_ready_jobs)
+{
+    if (OVERHEAD_MODEL == OVERHEAD_LINEAR)
+        return FREQUENCY_CALCULATION_OVERHEAD + FREQUENCY_CALCULATION_OVERHEAD_PER_JOB * num_ready_jobs + FREQUENCY_CALCULATION_OVERHEAD_PER_LEVEL * num_freq_levels;
+    else if (OVERHEAD_MODEL == OVERHEAD_TABLE)
+        return find_table_overhead(1, num_ready_jobs);
+
+    return FREQUENCY_CALCULATION_OVERHEAD;
+}
+
+
+/*
+ * Pre-condition: The largest number of jobs that can be ready at once (such as the number of tasks) and the latencies of the changes between the levels.
+ * Post-condition: The worst-case overheads that the scheduler can charge to a job: a decision point at its release and one at its completion (each with the slowest
+ * change between two levels), and the preemption of a lower priority job.
+ */
+float
+find_job_overheads(int num_ready_jobs)
+{
+    float max_latency = 0;
+    for (int i = 0; i < num_freq_levels * num_freq_levels; i++)
+    {
+        if (level_transitions[i].latency > max_latency)
+            max_latency = level_transitions[i].latency;
+    }
+
+    return 2 * (find_decision_making_overhead(num_ready_jobs) + find_frequency_calculation_overhead(num_ready_jobs) + max_latency) + PREEMPTION_OVERHEAD;
+}
+
+
+/*
+ * Pre-condition: The initialised overhead model.
+ * Post-condition: Prints the overheads of a decision point onto the output file.
+ */
+void
+print_overhead_model()
+{
+    if (OVERHEAD_MODEL == OVERHEAD_LINEAR)
+        fprintf(output_file, "Overhead model: decision making %0.3f + %0.3f per ready job, frequency calculation %0.3f + %0.3f per ready job + %0.3f per frequency level.\n", DECISION_MAKING_OVERHEAD, DECISION_MAKING_OVERHEAD_PER_JOB, FREQUENCY_CALCULATION_OVERHEAD, FREQUENCY_CALCULATION_OVERHEAD_PER_JOB, FREQUENCY_CALCULATION_OVERHEAD_PER_LEVEL);
+    else if (OVERHEAD_MODEL == OVERHEAD_TABLE)
+    {
+        fprintf(output_file, "Overhead model: measured on the target.\n");
+        for (int i = 0; i < num_overhead_entries; i++)
+            fprintf(output_file, "Ready jobs: %d, Decision making overhead: %0.3f, Frequency calculation overhead: %0.3f\n", overhead_table[i].num_ready_jobs, overhead_table[i].decision_making_overhead, overhead_table[i].frequency_calculation_overhead);
+    }
+
+    // The constant overheads are printed along with every decision point.
+    if (SCHEDULABILITY_WITH_OVERHEADS)
+        fprintf(output_file, "The schedulability tests charge every job with the worst-case overheads of its two decision points and a preemption.\n");
+    if (OVERHEAD_MODEL != OVERHEAD_CONSTANT || SCHEDULABILITY_WITH_OVERHEADS)
+        fprintf(output_file, "\n");
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The initialised overhead model.
+ * Post-condition: Frees the measured overheads (if any).
+ */
+void
+delete_overhead_model()
+{
+    free(overhead_table);
+    overhead_table = NULL;
+    num_overhead_entries = 0;
+
+    return;
+}
@@ -0,0 +1,18 @@
+// Overheads of a decision point measured on the target for some number of ready jobs (the ones in between are interpolated).
+typedef struct
+{
+    int num_ready_jobs;
+    float decision_making_overhead;
+    float frequency_calculation_overhead;
+}
+Overhead_entry;
+
+// Functions.
+void init_overhead_model(); // Reads the measured overheads (if the model is a table) and prints the model.
+void input_overhead_table(); // Reads the overheads of a decision point for every measured number of ready jobs.
+float find_table_overhead(int, int); // The overhead of one kind (0 = decision making, 1 = frequency calculation) for the given number of ready jobs.
+float find_decision_making_overhead(int); // The decision making overhead of a decision point with the given number of ready jobs.
+float find_frequency_calculation_overhead(int); // The frequency calculation overhead of a decision point with the given number of ready jobs.
+float find_job_overheads(int); // The worst-case overheads that the scheduler can charge to one job, with the given number of jobs ready.
+void print_overhead_model(); // Prints the overhead model.
+void delete_overhead_model(); // Frees the measured overheads.
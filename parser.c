@@ -0,0 +1,300 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "parser.h"
+
+// Powers of ten used to scale the digits of a floating point number.
+static const double powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+
+/*
+ * Pre-condition: An uninitialised input file and the name of the file to be read.
+ * Post-condition: The whole file is memory-mapped and ready to be scanned from the first line.
+ */
+void
+open_input_file(Input_file *file, const char *file_name)
+{
+    file->file_name = file_name;
+    file->data = NULL;
+    file->size = 0;
+    file->pos = 0;
+    file->line = 1;
+
+    int fd = open(file_name, O_RDONLY);
+    struct stat file_stat;
+    if (fd < 0 || fstat(fd, &file_stat) < 0)
+    {
+        fprintf(stderr, "ERROR: Could not open the input file %s.\n", file_name);
+        exit(0);
+    }
+
+    file->size = file_stat.st_size;
+
+    // An empty file cannot be mapped, but it is still a valid (empty) input.
+    if (file->size > 0)
+    {
+        file->data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (file->data == MAP_FAILED)
+        {
+            fprintf(stderr, "ERROR: Could not map the input file %s.\n", file_name);
+            exit(0);
+        }
+
+        // The file is read exactly once from the start to the end.
+        madvise(file->data, file->size, MADV_SEQUENTIAL);
+    }
+
+    // The mapping stays valid after the file descriptor is closed.
+    close(fd);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A memory-mapped input file.
+ * Post-condition: Unmaps the file.
+ */
+void
+close_input_file(Input_file *file)
+{
+    if (file->data != NULL)
+        munmap(file->data, file->size);
+
+    file->data = NULL;
+    file->size = 0;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A memory-mapped input file.
+ * Post-condition: The read position is moved to the next non-whitespace character (or to the end of the file).
+ */
+void
+skip_whitespace(Input_file *file)
+{
+    while (file->pos < file->size)
+    {
+        char c = file->data[file->pos];
+
+        if (c == '\n')
+            file->line++;
+        else if (c != ' ' && c != '\t' && c != '\r')
+            break;
+
+        file->pos++;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A memory-mapped input file.
+ * Post-condition: Scans the next integer into value and returns 1. Returns 0 (without moving past the bad token) if the next token is not an integer.
+ */
+int
+scan_long(Input_file *file, long *value)
+{
+    skip_whitespace(file);
+
+    size_t pos = file->pos;
+    int negative = 0;
+
+    if (pos < file->size && (file->data[pos] == '-' || file->data[pos] == '+'))
+    {
+        negative = (file->data[pos] == '-');
+        pos++;
+    }
+
+    // There has to be at least one digit.
+    if (pos >= file->size || file->data[pos] < '0' || file->data[pos] > '9')
+        return 0;
+
+    // A negative integer is accumulated as a negative number, so that LONG_MIN (whose magnitude is larger than LONG_MAX) can be scanned.
+    long result = 0;
+    while (pos < file->size && file->data[pos] >= '0' && file->data[pos] <= '9')
+    {
+        int digit = file->data[pos] - '0';
+        if (negative ? result < (LONG_MIN + digit) / 10 : result > (LONG_MAX - digit) / 10)
+            parse_error(file, file->line, "Integer too large");
+        result = negative ? result * 10 - digit : result * 10 + digit;
+        pos++;
+    }
+
+    // An integer cannot be directly followed by a fraction or any other character.
+    if (pos < file->size && file->data[pos] != ' ' && file->data[pos] != '\t' && file->data[pos] != '\r' && file->data[pos] != '\n')
+        return 0;
+
+    *value = result;
+    file->pos = pos;
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: A memory-mapped input file.
+ * Post-condition: Scans the next floating point number (with an optional fraction and exponent) into value and returns 1. Returns 0 if the next token is not a number.
+ */
+int
+scan_float(Input_file *file, float *value)
+{
+    skip_whitespace(file);
+
+    size_t pos = file->pos;
+    int negative = 0;
+
+    if (pos < file->size && (file->data[pos] == '-' || file->data[pos] == '+'))
+    {
+        negative = (file->data[pos] == '-');
+        pos++;
+    }
+
+    // All the significant digits (before and after the decimal point) are collected into one integer mantissa. Leading zeros are not significant.
+    unsigned long long mantissa = 0;
+    int num_digits = 0;
+    int num_significant_digits = 0;
+    int exponent = 0;
+
+    while (pos < file->size && file->data[pos] >= '0' && file->data[pos] <= '9')
+    {
+        if (num_significant_digits >= 18) // Digits beyond the precision of the mantissa only change the magnitude.
+            exponent++;
+        else if (num_significant_digits > 0 || file->data[pos] != '0')
+        {
+            mantissa = mantissa * 10 + (file->data[pos] - '0');
+            num_significant_digits++;
+        }
+        num_digits++;
+        pos++;
+    }
+
+    if (pos < file->size && file->data[pos] == '.')
+    {
+        pos++;
+        while (pos < file->size && file->data[pos] >= '0' && file->data[pos] <= '9')
+        {
+            if (num_significant_digits == 0 && file->data[pos] == '0') // A leading zero only moves the decimal point.
+                exponent--;
+            else if (num_significant_digits < 18)
+            {
+                mantissa = mantissa * 10 + (file->data[pos] - '0');
+                num_significant_digits++;
+                exponent--;
+            }
+            num_digits++;
+            pos++;
+        }
+    }
+
+    // There has to be at least one digit.
+    if (num_digits == 0)
+        return 0;
+
+    if (pos < file->size && (file->data[pos] == 'e' || file->data[pos] == 'E'))
+    {
+        pos++;
+        int exponent_negative = 0;
+        if (pos < file->size && (file->data[pos] == '-' || file->data[pos] == '+'))
+        {
+            exponent_negative = (file->data[pos] == '-');
+            pos++;
+        }
+
+        if (pos >= file->size || file->data[pos] < '0' || file->data[pos] > '9')
+            return 0;
+
+        int explicit_exponent = 0;
+        while (pos < file->size && file->data[pos] >= '0' && file->data[pos] <= '9')
+        {
+            if (explicit_exponent < 1000)
+                explicit_exponent = explicit_exponent * 10 + (file->data[pos] - '0');
+            pos++;
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+
+    // A number cannot be directly followed by any other character.
+    if (pos < file->size && file->data[pos] != ' ' && file->data[pos] != '\t' && file->data[pos] != '\r' && file->data[pos] != '\n')
+        return 0;
+
+    double result = (double) mantissa;
+    while (exponent > 18)
+    {
+        result *= powers_of_ten[18];
+        exponent -= 18;
+    }
+    while (exponent < -18)
+    {
+        result /= powers_of_ten[18];
+        exponent += 18;
+    }
+    result = (exponent >= 0) ? result * powers_of_ten[exponent] : result / powers_of_ten[-exponent];
+
+    *value = (float) (negative ? -result : result);
+    file->pos = pos;
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: A memory-mapped input file and a buffer of the given size.
+ * Post-condition: Scans the next word (everything till the next whitespace) into the buffer and returns 1. Returns 0 (without moving past the word) if there is no word or it does not fit.
+ */
+int
+scan_word(Input_file *file, char *word, size_t size)
+{
+    skip_whitespace(file);
+
+    size_t pos = file->pos;
+    while (pos < file->size && file->data[pos] != ' ' && file->data[pos] != '\t' && file->data[pos] != '\r' && file->data[pos] != '\n')
+        pos++;
+
+    size_t length = pos - file->pos;
+    if (length == 0 || length >= size)
+        return 0;
+
+    for (size_t i = 0; i < length; i++)
+        word[i] = file->data[file->pos + i];
+    word[length] = '\0';
+    file->pos = pos;
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: A memory-mapped input file.
+ * Post-condition: Returns 1 if only whitespace is left before the next new line (or the end of the file), 0 otherwise. The read position is not moved past the new line.
+ */
+int
+end_of_line(Input_file *file)
+{
+    while (file->pos < file->size && (file->data[file->pos] == ' ' || file->data[file->pos] == '\t' || file->data[file->pos] == '\r'))
+    {
+        file->pos++;
+    }
+
+    return (file->pos >= file->size || file->data[file->pos] == '\n');
+}
+
+
+/*
+ * Pre-condition: The input file in which the error was found, the line of the error and the description of the error.
+ * Post-condition: Prints the error and exits.
+ */
+void
+parse_error(Input_file *file, int line, const char *description)
+{
+    fprintf(stderr, "ERROR: %s (%s, line %d). Please enter valid data.\n", description, file->file_name, line);
+    exit(0);
+}
@@ -0,0 +1,21 @@
+#include <stddef.h>
+
+typedef struct
+{
+    const char *file_name; // Name of the file (used to report errors).
+    char *data; // Memory-mapped contents of the file.
+    size_t size; // Size of the file in bytes.
+    size_t pos; // Offset of the next character to be scanned.
+    int line; // Line number of the next character to be scanned (starts from 1).
+}
+Input_file;
+
+// Functions.
+void open_input_file(Input_file *, const char *); // Memory-maps the given file for reading.
+void close_input_file(Input_file *); // Unmaps the given file.
+void skip_whitespace(Input_file *); // Skips spaces, tabs and new lines while keeping track of the line number.
+int scan_long(Input_file *, long *); // Scans an integer (returns 1 on success and 0 otherwise).
+int scan_float(Input_file *, float *); // Scans a floating point number (returns 1 on success and 0 otherwise).
+int scan_word(Input_file *, char *, size_t); // Scans a word (such as a name) of at most the given size (returns 1 on success and 0 otherwise).
+int end_of_line(Input_file *); // Checks whether only whitespace is left on the current line.
+void parse_error(Input_file *, int, const char *); // Prints the error along with the file name and line number and exits.
@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "scheduler.h"
+#include "dpm.h"
+#include "histogram.h"
+#include "baseline.h"
+#include "report.h"
+#include "trace.h"
+#include "schedule_log.h"
+#include "partition.h"
+
+// Data of the main thread (the whole task-set).
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
+extern _Thread_local long hyperperiod;
+extern _Thread_local long first_in_phase_time;
+extern _Thread_local long end_of_execution_time;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Level_transition *level_transitions;
+extern _Thread_local Freq_and_voltage static_freq_and_voltage;
+extern _Thread_local int static_freq_and_voltage_index;
+extern _Thread_local long num_freq_calculations;
+extern _Thread_local long num_freq_changes;
+extern _Thread_local float total_dynamic_energy;
+
+// Statistics of the simulation running in the current thread.
+extern _Thread_local long num_context_switches;
+extern _Thread_local long num_preemptions;
+extern _Thread_local long num_cache_impact_points;
+extern _Thread_local int core_num;
+extern _Thread_local long num_deadline_misses;
+extern _Thread_local Histogram *task_histograms;
+extern _Thread_local int checkpoints_enabled;
+extern unsigned long long simulation_seed;
+
+Core cores[NUM_CORES];
+
+// Copies of the data of the main thread that every core thread needs.
+static long shared_hyperperiod;
+static long shared_first_in_phase_time;
+static long shared_end_of_execution_time;
+static int shared_num_freq_levels;
+static Freq_and_voltage *shared_freq_and_voltage;
+static Level_transition *shared_level_transitions;
+
+
+/*
+ * Pre-condition: The sorted task-set, the frequencies and the metadata of the task-set.
+ * Post-condition: Partitions the task-set across NUM_CORES cores, simulates all the cores in parallel and prints the statistics of every core and of the whole system.
+ */
+void
+start_partitioned_scheduler()
+{
+    fprintf(output_file, "------------------------------------------------------------\n");
+    fprintf(output_file, "Partitioned scheduling on %d cores. (Every core has its own frequency domain).\n", NUM_CORES);
+
+    partition_tasks();
+    print_partition();
+
+    shared_hyperperiod = hyperperiod;
+    shared_first_in_phase_time = first_in_phase_time;
+    shared_end_of_execution_time = end_of_execution_time;
+    shared_num_freq_levels = num_freq_levels;
+    shared_freq_and_voltage = freq_and_voltage;
+    shared_level_transitions = level_transitions;
+
+    // The cores share no state while they are simulated.
+    pthread_t threads[NUM_CORES];
+    for (int i = 0; i < NUM_CORES; i++)
+    {
+        if (pthread_create(&threads[i], NULL, simulate_core, &cores[i]) != 0)
+        {
+            fprintf(stderr, "ERROR: Could not create the thread for core %d.\n", i);
+            exit(0);
+        }
+    }
+
+    for (int i = 0; i < NUM_CORES; i++)
+        pthread_join(threads[i], NULL);
+
+    fprintf(output_file, "\nDisclaimer: The schedule of core i is in output_file_core_i.txt, and its statistics are in output_statistics_file_core_i.txt.\n");
+    print_core_statistics();
+    merge_core_histograms();
+
+    for (int i = 0; i < NUM_CORES; i++)
+        free(cores[i].tasks);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The task-set.
+ * Post-condition: Every task is assigned to a core. The tasks of every core are sorted based on period.
+ */
+void
+partition_tasks()
+{
+    for (int i = 0; i < NUM_CORES; i++)
+    {
+        cores[i].core_num = i;
+        cores[i].num_tasks = 0;
+        cores[i].tasks = (Task *) malloc(sizeof(Task) * num_tasks);
+        cores[i].task_utilisation = 0;
+    }
+
+    // The tasks are considered in decreasing order of utilisation.
+    Task *sorted_tasks = (Task *) malloc(sizeof(Task) * num_tasks);
+    memcpy(sorted_tasks, tasks, sizeof(Task) * num_tasks);
+    qsort(sorted_tasks, num_tasks, sizeof(Task), sort_tasks_utilisation_comparator);
+
+    for (int i = 0; i < num_tasks; i++) // Iterating through each task in decreasing order of utilisation.
+    {
+        Task task = sorted_tasks[i];
+        float task_utilisation = task.wcet / task.period;
+        int chosen_core = -1;
+
+        for (int j = 0; j < NUM_CORES; j++) // Iterating through each core.
+        {
+            if (!core_accepts_task(&cores[j], &task))
+                continue;
+
+            if (PARTITIONING_HEURISTIC == FIRST_FIT_DECREASING)
+            {
+                chosen_core = j;
+                break;
+            }
+            else if (chosen_core == -1)
+                chosen_core = j;
+            else if (PARTITIONING_HEURISTIC == BEST_FIT_DECREASING && cores[j].task_utilisation > cores[chosen_core].task_utilisation) // Fullest core that fits.
+                chosen_core = j;
+            else if (PARTITIONING_HEURISTIC == WORST_FIT_DECREASING && cores[j].task_utilisation < cores[chosen_core].task_utilisation) // Emptiest core that fits.
+                chosen_core = j;
+        }
+
+        // Just like on one core, a task-set that does not fit is still simulated (on the least loaded core).
+        if (chosen_core == -1)
+        {
+            chosen_core = 0;
+            for (int j = 1; j < NUM_CORES; j++)
+            {
+                if (cores[j].task_utilisation < cores[chosen_core].task_utilisation)
+                    chosen_core = j;
+            }
+            fprintf(output_file, "Task-%d does not fit on any core. Assigning it to the least loaded core (core %d). Might NOT be able to schedule all jobs completely.\n", task.task_num, chosen_core);
+        }
+
+        Core *core = &cores[chosen_core];
+        core->tasks[core->num_tasks++] = task;
+        core->task_utilisation += task_utilisation;
+
+        // The tasks of a core have to stay sorted based on period for RM.
+        qsort(core->tasks, core->num_tasks, sizeof(Task), sort_tasks_comparator);
+    }
+
+    free(sorted_tasks);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A core with its tasks sorted based on period and a task that is not yet assigned.
+ * Post-condition: Returns 1 if the tasks of the core along with the given task pass the configured schedulability test at Fmax, 0 otherwise.
+ */
+int
+core_accepts_task(Core *core, Task *task)
+{
+    // The core with the new task (sorted based on period).
+    Task *task_set = (Task *) malloc(sizeof(Task) * (core->num_tasks + 1));
+    memcpy(task_set, core->tasks, sizeof(Task) * core->num_tasks);
+    task_set[core->num_tasks] = *task;
+    qsort(task_set, core->num_tasks + 1, sizeof(Task), sort_tasks_comparator);
+
+    float max_freq = freq_and_voltage[num_freq_levels - 1].freq;
+    int result;
+    if (PARTITIONING_USES_RTA)
+        result = response_time_test(task_set, core->num_tasks + 1, max_freq);
+    else
+        result = rm_test_task_set(task_set, core->num_tasks + 1, max_freq);
+
+    free(task_set);
+
+    return result;
+}
+
+
+/*
+ * Pre-condition: A core with its tasks. (Runs in its own thread, so all the simulation data is thread-local.)
+ * Post-condition: Simulates the schedule of the core at its own static and dynamic frequencies, and stores the results in the core.
+ */
+void *
+simulate_core(void *arg)
+{
+    Core *core = (Core *) arg;
+
+    // The core schedules only its own tasks over the same horizon as the whole task-set.
+    core_num = core->core_num;
+    num_tasks = core->num_tasks;
+    tasks = (Task *) calloc(num_tasks, sizeof(Task));
+    memcpy(tasks, core->tasks, sizeof(Task) * num_tasks);
+    hyperperiod = shared_hyperperiod;
+    first_in_phase_time = shared_first_in_phase_time;
+    end_of_execution_time = shared_end_of_execution_time;
+    num_freq_levels = shared_num_freq_levels;
+    freq_and_voltage = shared_freq_and_voltage;
+    level_transitions = shared_level_transitions;
+
+    char output_file_name[256], statistics_file_name[256];
+    snprintf(output_file_name, sizeof(output_file_name), "output_file_core_%d.txt", core_num);
+    snprintf(statistics_file_name, sizeof(statistics_file_name), "output_statistics_file_core_%d.txt", core_num);
+    output_file = fopen(output_file_name, "w");
+    statistics_file = fopen(statistics_file_name, "w");
+    if (!output_file || !statistics_file)
+    {
+        fprintf(stderr, "ERROR: Could not open the required files.\n");
+        exit(0);
+    }
+    if (TRACE_EXPORT)
+    {
+        char trace_file_name[256];
+        snprintf(trace_file_name, sizeof(trace_file_name), "output_trace_core_%d.json", core_num);
+        open_trace(trace_file_name);
+    }
+    if (SCHEDULE_LOG)
+    {
+        char schedule_log_file_name[256];
+        snprintf(schedule_log_file_name, sizeof(schedule_log_file_name), "output_schedule_log_core_%d.bin", core_num);
+        open_schedule_log(schedule_log_file_name);
+    }
+
+    fprintf(output_file, "Core %d.\n", core_num);
+    print_tasks();
+
+    // Every core is its own frequency domain (and takes its own snapshots).
+    find_static_freq_and_voltage();
+    create_sort_print_jobs();
+    checkpoints_enabled = 1;
+    start_scheduler();
+
+    // Storing the results.
+    core->static_freq_and_voltage_index = static_freq_and_voltage_index;
+    core->num_jobs = num_jobs;
+    core->num_finished_jobs = 0;
+    for (int i = 0; i < num_jobs; i++)
+    {
+        if (jobs[i].alive == false)
+            core->num_finished_jobs++;
+    }
+    core->total_dynamic_energy = total_dynamic_energy;
+    core->num_context_switches = num_context_switches;
+    core->num_preemptions = num_preemptions;
+    core->num_cache_impact_points = num_cache_impact_points;
+    core->num_freq_calculations = num_freq_calculations;
+    core->num_freq_changes = num_freq_changes;
+    core->total_energy = find_total_energy();
+    core->num_deadline_misses = num_deadline_misses;
+
+    // The histograms are handed over to the main thread.
+    core->task_histograms = task_histograms;
+    task_histograms = NULL;
+
+    fprintf(output_file, "\n--------------------------- THE END ---------------------------\n");
+    fprintf(statistics_file, "\n--------------------------- THE END ---------------------------\n");
+    fclose(output_file);
+    fclose(statistics_file);
+    close_trace();
+    close_schedule_log();
+    delete_jobs();
+    delete_tasks();
+
+    return NULL;
+}
+
+
+/*
+ * Pre-condition: The tasks assigned to every core.
+ * Post-condition: Prints the partition onto the output file.
+ */
+void
+print_partition()
+{
+    const char *heuristics[] = {"First-fit decreasing", "Best-fit decreasing", "Worst-fit decreasing"};
+    fprintf(output_file, "Partitioning heuristic: %s (using %s).\n", heuristics[PARTITIONING_HEURISTIC], PARTITIONING_USES_RTA ? "response-time analysis" : "rm_test()");
+
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        fprintf(output_file, "Core %d (utilisation: %0.2f): ", i, cores[i].task_utilisation);
+        for (int j = 0; j < cores[i].num_tasks; j++)
+            fprintf(output_file, "Task-%d, ", cores[i].tasks[j].task_num);
+        fprintf(output_file, "\n");
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The results of the simulation of every core.
+ * Post-condition: Prints the statistics of every core and the totals of the system onto the statistics file.
+ */
+void
+print_core_statistics()
+{
+    float total_system_dynamic_energy = 0, total_system_energy = 0;
+    long total_context_switches = 0, total_preemptions = 0, total_cache_impact_points = 0, total_freq_calculations = 0, total_freq_changes = 0;
+    int total_jobs = 0, total_finished_jobs = 0;
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Partitioned scheduling on %d cores.\n", NUM_CORES);
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        Core core = cores[i];
+        fprintf(statistics_file, "Core %d: Tasks: %d, Utilisation: %0.2f, Static freq: %0.2f, Finished jobs: %d/%d, Dynamic energy: %0.2f, Total energy: %0.2f, Context-switches: %ld, Preemptions: %ld, Cache-impact points: %ld, Frequency calculations: %ld, Frequency changes: %ld\n", i, core.num_tasks, core.task_utilisation, freq_and_voltage[core.static_freq_and_voltage_index].freq, core.num_finished_jobs, core.num_jobs, core.total_dynamic_energy, core.total_energy, core.num_context_switches, core.num_preemptions, core.num_cache_impact_points, core.num_freq_calculations, core.num_freq_changes);
+
+        total_system_dynamic_energy += core.total_dynamic_energy;
+        total_system_energy += core.total_energy;
+        total_context_switches += core.num_context_switches;
+        total_preemptions += core.num_preemptions;
+        total_cache_impact_points += core.num_cache_impact_points;
+        total_freq_calculations += core.num_freq_calculations;
+        total_freq_changes += core.num_freq_changes;
+        total_jobs += core.num_jobs;
+        total_finished_jobs += core.num_finished_jobs;
+    }
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Total dynamic-energy consumer: %0.2f\n", total_system_dynamic_energy);
+    fprintf(statistics_file, "Total energy consumed: %0.2f\n", total_system_energy);
+    fprintf(statistics_file, "Total number of finished jobs: %d/%d\n", total_finished_jobs, total_jobs);
+    fprintf(statistics_file, "Total number of context-switches: %ld\n", total_context_switches);
+    fprintf(statistics_file, "Total number of preemptions: %ld\n", total_preemptions);
+    fprintf(statistics_file, "Total number of cache-impact points: %ld\n", total_cache_impact_points);
+    fprintf(statistics_file, "Total number of frequency calculations: %ld\n", total_freq_calculations);
+    fprintf(statistics_file, "Total number of frequency changes: %ld\n", total_freq_changes);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The results of the simulation of every core, along with the histograms of its tasks.
+ * Post-condition: The histograms of the whole task-set hold those of the cores. Prints their percentiles onto the statistics file and writes the machine-readable statistics of the system.
+ */
+void
+merge_core_histograms()
+{
+    Simulation_summary summary = {0};
+
+    init_task_histograms();
+    for (int i = 0; i < NUM_CORES; i++) // Iterating through each core.
+    {
+        for (int j = 0; j < cores[i].num_tasks; j++)
+        {
+            // The histograms of a core are indexed by the sorted task number on the core.
+            for (int k = 0; k < num_tasks; k++)
+            {
+                if (tasks[k].task_num != cores[i].tasks[j].task_num)
+                    continue;
+
+                for (int l = 0; l < NUM_TASK_HISTOGRAMS; l++)
+                    merge_histograms(&task_histograms[k * NUM_TASK_HISTOGRAMS + l], &cores[i].task_histograms[j * NUM_TASK_HISTOGRAMS + l]);
+            }
+        }
+
+        summary.total_dynamic_energy += cores[i].total_dynamic_energy;
+        summary.total_energy += cores[i].total_energy;
+        summary.num_freq_calculations += cores[i].num_freq_calculations;
+        summary.num_freq_changes += cores[i].num_freq_changes;
+        summary.num_context_switches += cores[i].num_context_switches;
+        summary.num_preemptions += cores[i].num_preemptions;
+        summary.num_deadline_misses += cores[i].num_deadline_misses;
+        summary.num_finished_jobs += cores[i].num_finished_jobs;
+
+        free(cores[i].task_histograms);
+        cores[i].task_histograms = NULL;
+    }
+
+    print_task_histograms();
+    write_json_statistics(&summary, simulation_seed, end_of_execution_time);
+
+    return;
+}
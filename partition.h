@@ -0,0 +1,33 @@
+typedef struct
+{
+    int core_num;
+
+    // Tasks assigned to the core (sorted based on period).
+    int num_tasks;
+    Task *tasks;
+    float task_utilisation;
+
+    // Results of the simulation of the core.
+    int static_freq_and_voltage_index;
+    int num_jobs;
+    int num_finished_jobs;
+    float total_dynamic_energy;
+    long num_context_switches;
+    long num_preemptions;
+    long num_cache_impact_points;
+    long num_freq_calculations;
+    long num_freq_changes;
+    float total_energy;
+    long num_deadline_misses;
+    Histogram *task_histograms; // Histograms of the tasks of the core (merged into those of the whole task-set once all the cores are done).
+}
+Core;
+
+// Functions.
+void start_partitioned_scheduler(); // Partitions the task-set across the cores, simulates every core in its own thread and prints the per-core statistics.
+void partition_tasks(); // Assigns every task to a core using the configured bin-packing heuristic.
+int core_accepts_task(Core *, Task *); // Checks whether the core stays schedulable (at Fmax) with the given task added to it.
+void *simulate_core(void *); // Simulates the schedule of one core (runs in its own thread).
+void print_partition(); // Prints the tasks assigned to every core.
+void print_core_statistics(); // Prints the per-core and total statistics after all the cores have been simulated.
+void merge_core_histograms(); // Collects the histograms of all the cores into those of the whole task-set and writes the machine-readable statistics.
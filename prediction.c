@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "prediction.h"
+
+// Global variables required to predict the execution times of the jobs.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+
+// Tasks.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+
+// The prediction of every task (sorted based on period), along with how good it was.
+_Thread_local float *predicted_execution_times;
+_Thread_local float *prediction_errors; // Sum of the absolute errors of the predictions of the finished jobs.
+_Thread_local int *num_predictions;
+_Thread_local int *num_prediction_overruns;
+
+
+/*
+ * Pre-condition: The sorted task-set.
+ * Post-condition: Every task is predicted to run for its wcet till the first of its jobs finishes.
+ */
+void
+init_aet_prediction()
+{
+    predicted_execution_times = (float *) calloc(num_tasks, sizeof(float));
+    prediction_errors = (float *) calloc(num_tasks, sizeof(float));
+    num_predictions = (int *) calloc(num_tasks, sizeof(int));
+    num_prediction_overruns = (int *) calloc(num_tasks, sizeof(int));
+
+    for (int i = 0; i < num_tasks; i++)
+        predicted_execution_times[i] = tasks[i].wcet;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task number of a job that is being released.
+ * Post-condition: Returns the execution time the job is predicted to run for.
+ */
+float
+predict_execution_time(int sorted_task_num)
+{
+    return predicted_execution_times[sorted_task_num];
+}
+
+
+/*
+ * Pre-condition: An unfinished job in the ready queue.
+ * Post-condition: Returns the time the job is budgeted for till it finishes.
+ *
+ * Till the job has executed for its predicted time, it is budgeted for the rest of the prediction. Once it overruns the prediction, it falls back to the rest of its wcet, so the frequency is never lower than what is safe for the job.
+ */
+float
+find_predicted_demand(const Job *job)
+{
+    if (job->time_executed < job->predicted_time - PREDICTION_EPSILON)
+        return job->predicted_time - job->time_executed;
+
+    return job->wcet - job->time_executed;
+}
+
+
+/*
+ * Pre-condition: The sorted task number, the prediction and the actual execution time of a job that just finished.
+ * Post-condition: The prediction of the task is updated as an exponentially weighted moving average of the actual execution times.
+ */
+void
+update_aet_prediction(int sorted_task_num, float predicted_time, float aet)
+{
+    prediction_errors[sorted_task_num] += (aet > predicted_time) ? aet - predicted_time : predicted_time - aet;
+    num_predictions[sorted_task_num]++;
+
+    predicted_execution_times[sorted_task_num] = AET_PREDICTION_WEIGHT * aet + (1 - AET_PREDICTION_WEIGHT) * predicted_execution_times[sorted_task_num];
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A job that has just executed for its predicted time without finishing.
+ * Post-condition: The overrun is counted for the task of the job.
+ */
+void
+add_prediction_overrun(const Job *job)
+{
+    num_prediction_overruns[job->sorted_task_num]++;
+    fprintf(output_file, "Job J%d,%d: Overran its predicted execution time of %0.2f. Falling back to its wcet.\n", job->task_num, job->instance_num, job->predicted_time);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The prediction data after the scheduler has finished.
+ * Post-condition: Prints the final prediction, the mean absolute error and the number of overruns of every task onto the statistics file.
+ */
+void
+print_prediction_statistics()
+{
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Execution time prediction statistics (EWMA weight: %0.2f):\n", AET_PREDICTION_WEIGHT);
+    for (int i = 0; i < num_tasks; i++)
+    {
+        float mean_error = (num_predictions[i] > 0) ? prediction_errors[i] / num_predictions[i] : 0;
+        fprintf(statistics_file, "Task-%d: Prediction: %0.2f (WCET: %0.2f), Mean absolute error: %0.2f, Overruns: %d of %d jobs\n", tasks[i].task_num, predicted_execution_times[i], tasks[i].wcet, mean_error, num_prediction_overruns[i], num_predictions[i]);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The prediction data.
+ * Post-condition: Frees the heap data related to the prediction.
+ */
+void
+delete_aet_prediction()
+{
+    free(predicted_execution_times);
+    free(prediction_errors);
+    free(num_predictions);
+    free(num_prediction_overruns);
+    predicted_execution_times = NULL;
+
+    return;
+}
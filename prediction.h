@@ -0,0 +1,8 @@
+// Functions.
+void init_aet_prediction(); // Initialises the predicted execution time of every task to its wcet.
+float predict_execution_time(int); // Returns the predicted execution time of the next job of a task.
+float find_predicted_demand(const Job *); // Returns the time a job is budgeted for by the prediction (or its wcet-safe remaining time after an overrun).
+void update_aet_prediction(int, float, float); // Updates the prediction of a task with the actual execution time of a finished job.
+void add_prediction_overrun(const Job *); // Records that a job ran past its prediction.
+void print_prediction_statistics(); // Prints the prediction errors and overruns of every task.
+void delete_aet_prediction(); // Frees the prediction data.
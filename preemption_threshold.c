@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "preemption_threshold.h"
+
+// Global variables required for preemption-threshold scheduling.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+
+// Tasks and frequency (and voltage) data.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Freq_and_voltage static_freq_and_voltage;
+
+// Run-time flag of the policy.
+extern _Thread_local int preemption_threshold_scheduling;
+
+// Threshold of every task (sorted based on period), as the sorted task number of the highest priority task that cannot preempt its started jobs.
+_Thread_local int *preemption_thresholds;
+
+
+/*
+ * Pre-condition: The sorted task-set and the static frequency.
+ * Post-condition: Every task has its own priority as its threshold (plain RM), unless preemption-threshold scheduling is on and higher thresholds keep the task-set schedulable.
+ *
+ * The thresholds are found at the static frequency, and at Fmax if the task-set does not pass response-time analysis at the static frequency.
+ */
+void
+init_preemption_thresholds()
+{
+    preemption_thresholds = (int *) malloc(sizeof(int) * (num_tasks + 1));
+    for (int i = 0; i < num_tasks; i++)
+        preemption_thresholds[i] = i;
+
+    if (!preemption_threshold_scheduling)
+        return;
+
+    float relative_freq = static_freq_and_voltage.freq;
+    if (!preemption_threshold_test(tasks, preemption_thresholds, num_tasks, relative_freq))
+        relative_freq = freq_and_voltage[num_freq_levels - 1].freq;
+
+    if (preemption_threshold_test(tasks, preemption_thresholds, num_tasks, relative_freq))
+    {
+        find_preemption_thresholds(relative_freq);
+        fprintf(output_file, "Preemption thresholds (found at frequency %0.2f):\n", relative_freq);
+    }
+    else
+        fprintf(output_file, "The task-set is not schedulable under response-time analysis even at Fmax, so the preemption thresholds are the priorities of the tasks (plain RM).\n");
+
+    print_preemption_thresholds();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A task-set that is schedulable at the given frequency with every threshold equal to the priority of its task.
+ * Post-condition: The threshold of every task is as high as it can be while the task-set stays schedulable (under response-time analysis for preemption-threshold scheduling).
+ *
+ * The thresholds are raised one priority level at a time, from the highest priority task to the lowest. A higher threshold can only make the other tasks less schedulable (by blocking them), so the search stops for a task at the first level that fails.
+ */
+void
+find_preemption_thresholds(float relative_freq)
+{
+    for (int i = 0; i < num_tasks; i++) // Iterating through all tasks.
+    {
+        while (preemption_thresholds[i] > 0)
+        {
+            preemption_thresholds[i]--;
+            if (!preemption_threshold_test(tasks, preemption_thresholds, num_tasks, relative_freq))
+            {
+                preemption_thresholds[i]++;
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A job in the ready queue.
+ * Post-condition: Returns the priority the job is ordered by in the ready queue (smaller is higher).
+ *
+ * A job that has started runs at the threshold of its task, and a job that has not started at the priority of its task. A new job is put ahead of a
+ * started job (and so preempts it) only if its task is of higher priority than the threshold, hence the started job is ordered just before the jobs of its threshold.
+ */
+int
+find_ready_queue_priority(const Job *job)
+{
+    if (job->time_executed > 0)
+        return 2 * preemption_thresholds[job->sorted_task_num];
+
+    return 2 * job->sorted_task_num + 1;
+}
+
+
+/*
+ * Pre-condition: The thresholds of the tasks.
+ * Post-condition: Prints the threshold of every task onto the output file.
+ */
+void
+print_preemption_thresholds()
+{
+    for (int i = 0; i < num_tasks; i++)
+        fprintf(output_file, "Task-%d: Priority: %d, Preemption threshold: %d (Task-%d)\n", tasks[i].task_num, i, preemption_thresholds[i], tasks[preemption_thresholds[i]].task_num);
+    fprintf(output_file, "\n");
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The thresholds of the tasks.
+ * Post-condition: Frees the thresholds.
+ */
+void
+delete_preemption_thresholds()
+{
+    free(preemption_thresholds);
+
+    return;
+}
@@ -0,0 +1,6 @@
+// Functions.
+void init_preemption_thresholds(); // Finds the preemption threshold of every task (if the policy is on).
+void find_preemption_thresholds(float); // Raises the threshold of every task as far as the task-set stays schedulable at the given frequency.
+int find_ready_queue_priority(const Job *); // The priority of a job in the ready queue (smaller is higher).
+void print_preemption_thresholds(); // Prints the threshold of every task.
+void delete_preemption_thresholds(); // Frees the thresholds.
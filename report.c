@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "histogram.h"
+#include "baseline.h"
+#include "report.h"
+
+// Global variables required to write the machine-readable statistics.
+
+// Output files (the machine-readable statistics file is NULL if it is not written, as in the baseline and per-core simulations).
+extern _Thread_local FILE *json_file;
+
+// Tasks and their histograms.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local Histogram *task_histograms;
+
+static const char *const task_histogram_keys[NUM_TASK_HISTOGRAMS] = {"response_time", "waiting_time", "lateness"};
+
+
+/*
+ * Pre-condition: The summary of a simulation that has just finished, its seed and the time it ended at, along with the histograms of the tasks.
+ * Post-condition: Writes them as one JSON object onto the machine-readable statistics file (if it is open).
+ */
+void
+write_json_statistics(const Simulation_summary *summary, unsigned long long seed, float end_time)
+{
+    if (!json_file)
+        return;
+
+    fprintf(json_file, "{\n");
+    fprintf(json_file, "  \"seed\": %llu,\n", seed);
+    fprintf(json_file, "  \"end_time\": %g,\n", end_time);
+    fprintf(json_file, "  \"dynamic_energy\": %g,\n", summary->total_dynamic_energy);
+    fprintf(json_file, "  \"total_energy\": %g,\n", summary->total_energy);
+    fprintf(json_file, "  \"frequency_calculations\": %ld,\n", summary->num_freq_calculations);
+    fprintf(json_file, "  \"frequency_changes\": %ld,\n", summary->num_freq_changes);
+    fprintf(json_file, "  \"context_switches\": %ld,\n", summary->num_context_switches);
+    fprintf(json_file, "  \"preemptions\": %ld,\n", summary->num_preemptions);
+    fprintf(json_file, "  \"deadline_misses\": %ld,\n", summary->num_deadline_misses);
+    fprintf(json_file, "  \"finished_jobs\": %d,\n", summary->num_finished_jobs);
+
+    // The bucket i != 0 of a histogram holds the magnitudes (negative values for i < 0) from min_value * 2^octave * (1 + sub / sub_buckets) to min_value * 2^octave * (1 + (sub + 1) / sub_buckets),
+    // where octave = (|i| - 1) / sub_buckets and sub = (|i| - 1) % sub_buckets, as in find_histogram_bucket_value() (the last bucket also holds anything larger). The bucket 0 holds the magnitudes below min_value.
+    fprintf(json_file, "  \"histogram\": {\"min_value\": %g, \"sub_buckets\": %d, \"octaves\": %d},\n", HISTOGRAM_MIN_VALUE, HISTOGRAM_SUB_BUCKETS, HISTOGRAM_NUM_OCTAVES);
+
+    fprintf(json_file, "  \"tasks\": [\n");
+    for (int i = 0; i < num_tasks; i++)
+    {
+        fprintf(json_file, "    {\"task\": %d, \"period\": %ld, \"deadline\": %ld, \"wcet\": %g", tasks[i].task_num, tasks[i].period, tasks[i].deadline, tasks[i].wcet);
+        for (int k = 0; k < NUM_TASK_HISTOGRAMS; k++)
+        {
+            fprintf(json_file, ",\n      \"%s\": ", task_histogram_keys[k]);
+            write_histogram_json(json_file, &task_histograms[i * NUM_TASK_HISTOGRAMS + k]);
+        }
+        fprintf(json_file, "}%s\n", (i < num_tasks - 1) ? "," : "");
+    }
+    fprintf(json_file, "  ],\n");
+
+    // The histograms of all the tasks together.
+    fprintf(json_file, "  \"all_tasks\": {");
+    for (int k = 0; k < NUM_TASK_HISTOGRAMS; k++)
+    {
+        Histogram all_tasks;
+        init_histogram(&all_tasks);
+        for (int i = 0; i < num_tasks; i++)
+            merge_histograms(&all_tasks, &task_histograms[i * NUM_TASK_HISTOGRAMS + k]);
+
+        fprintf(json_file, "%s\n    \"%s\": ", (k > 0) ? "," : "", task_histogram_keys[k]);
+        write_histogram_json(json_file, &all_tasks);
+    }
+    fprintf(json_file, "\n  }\n");
+    fprintf(json_file, "}\n");
+
+    return;
+}
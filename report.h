@@ -0,0 +1,2 @@
+// Functions.
+void write_json_statistics(const Simulation_summary *, unsigned long long, float); // Writes the summary and the histograms of every task onto the machine-readable statistics file.
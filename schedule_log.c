@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "freq_and_voltage.h"
+#include "taskset_cache.h"
+#include "schedule_log.h"
+
+// Global variables required to record the schedule.
+
+// Tasks and frequency (and voltage) data.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local long end_of_execution_time;
+
+// Schedule log of the simulation running in this thread (NULL if it is not recorded, as in the baseline simulation).
+_Thread_local FILE *schedule_log_file;
+
+
+/*
+ * Pre-condition: The name of the schedule log.
+ * Post-condition: The schedule log is opened with a large buffer (the records are written as they happen).
+ */
+void
+open_schedule_log(const char *file_name)
+{
+    schedule_log_file = fopen(file_name, "wb");
+    if (!schedule_log_file)
+    {
+        fprintf(stderr, "ERROR: Could not open the schedule log %s.\n", file_name);
+        exit(0);
+    }
+    setvbuf(schedule_log_file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task-set and the frequencies of the simulation that is starting, the core it runs on and its seed.
+ * Post-condition: The header, the tasks and the frequency levels are written, so that the log can be analysed on its own.
+ * A task-set with LOG_NO_TASK tasks or more is rejected, as their sorted task numbers do not fit the task field of a record.
+ */
+void
+write_schedule_log_header(int core_num, unsigned long long seed)
+{
+    if (!schedule_log_file)
+        return;
+
+    if (num_tasks >= LOG_NO_TASK)
+    {
+        fprintf(stderr, "ERROR: The schedule log can only record task-sets of fewer than %d tasks (the task-set has %d). Please turn off SCHEDULE_LOG.\n", LOG_NO_TASK, num_tasks);
+        exit(0);
+    }
+
+    Schedule_log_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCHEDULE_LOG_MAGIC, sizeof(SCHEDULE_LOG_MAGIC));
+    header.core_num = core_num;
+    header.num_tasks = num_tasks;
+    header.num_freq_levels = num_freq_levels;
+    header.end_of_execution_time = end_of_execution_time;
+    header.seed = seed;
+    fwrite(&header, sizeof(header), 1, schedule_log_file);
+
+    for (int i = 0; i < num_tasks; i++)
+    {
+        Cached_task task;
+        memset(&task, 0, sizeof(task));
+        task.task_num = tasks[i].task_num;
+        task.num_instances = tasks[i].num_instances;
+        task.phase = tasks[i].phase;
+        task.period = tasks[i].period;
+        task.deadline = tasks[i].deadline;
+        task.wcet = tasks[i].wcet;
+        fwrite(&task, sizeof(task), 1, schedule_log_file);
+    }
+
+    fwrite(freq_and_voltage, sizeof(Freq_and_voltage), num_freq_levels, schedule_log_file);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The type of a record, its frequency level, its (sorted) task and instance, and the values of the type.
+ * Post-condition: The record is appended to the schedule log (if it is open).
+ */
+void
+log_record(int type, int level, int task, int instance_num, float start, float end, float energy, float value)
+{
+    if (!schedule_log_file)
+        return;
+
+    Log_record record;
+    record.type = type;
+    record.level = level;
+    record.task = (task < 0) ? LOG_NO_TASK : task;
+    record.instance_num = instance_num;
+    record.start = start;
+    record.end = end;
+    record.energy = energy;
+    record.value = value;
+    fwrite(&record, sizeof(record), 1, schedule_log_file);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The type of a record, its frequency level, the job and the values of the type.
+ * Post-condition: The record of the job is appended to the schedule log.
+ */
+void
+log_job_record(int type, int level, const Job *job, float start, float end, float energy, float value)
+{
+    log_record(type, level, job->sorted_task_num, job->instance_num, start, end, energy, value);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: None.
+ * Post-condition: The schedule log (if it is open) is closed.
+ */
+void
+close_schedule_log()
+{
+    if (!schedule_log_file)
+        return;
+
+    fclose(schedule_log_file);
+    schedule_log_file = NULL;
+
+    return;
+}
@@ -0,0 +1,58 @@
+#define SCHEDULE_LOG_MAGIC "CCRMLG1"
+
+// Types of the records of the schedule log.
+#define LOG_JOB_RELEASE 0 // start: arrival time, end: absolute deadline, value: actual execution time.
+#define LOG_JOB_SEGMENT 1 // start and end of an executed segment, energy: its dynamic energy.
+#define LOG_JOB_COMPLETION 2 // start: arrival time, end: finish time, energy: dynamic energy of the job, value: actual execution time.
+#define LOG_OVERHEAD 3 // task: kind of overhead, instance_num: sorted task number of a cache reload, start and end of the overhead, energy: its energy.
+#define LOG_FREQUENCY_CALCULATION 4 // start: time, value: dynamic task utilisation.
+#define LOG_FREQUENCY_CHANGE 5 // task: previous level, level: new level, start: time.
+#define LOG_IDLE 6 // level: 0 when idle or the sleep state + 1, start and end of the interval, energy: idle or sleep energy, value: transition energy.
+#define LOG_DEADLINE_MISS 7 // start: absolute deadline.
+#define LOG_PREEMPTION 8 // instance_num and value: instance and task number of the preempted job, start: time.
+#define LOG_CONTEXT_SWITCH 9 // start: time, value: 1 if it is also a cache impact point.
+#define LOG_CACHE_IMPACT_POINT 10 // start: time (a cache impact point that is not a context switch).
+#define NUM_LOG_RECORD_TYPES 11
+
+// Kinds of overheads (in the task field of LOG_OVERHEAD).
+#define LOG_DECISION_MAKING_OVERHEAD 0
+#define LOG_FREQUENCY_CALCULATION_OVERHEAD 1
+#define LOG_FREQUENCY_CHANGE_OVERHEAD 2
+#define LOG_PREEMPTION_OVERHEAD 3
+#define LOG_CACHE_RELOAD_OVERHEAD 4
+#define NUM_LOG_OVERHEADS 5
+
+#define LOG_NO_TASK 0xFFFF // Also the limit on the number of tasks of a logged task-set.
+
+// Header of the schedule log. It is followed by the tasks (Cached_task of taskset_cache.h), the frequency levels (Freq_and_voltage) and then the records till the end of the file.
+typedef struct
+{
+    char magic[8]; // Identifies the file as a schedule log of this format version.
+    int core_num;
+    int num_tasks;
+    int num_freq_levels;
+    long end_of_execution_time;
+    unsigned long long seed;
+}
+Schedule_log_header;
+
+// One event of the schedule (24 bytes). The meaning of the fields depends on the type.
+typedef struct
+{
+    unsigned char type;
+    unsigned char level; // Frequency level (or sleep state) of the event.
+    unsigned short task; // Sorted task number (LOG_NO_TASK if the event has no task).
+    int instance_num;
+    float start;
+    float end;
+    float energy;
+    float value;
+}
+Log_record;
+
+// Functions.
+void open_schedule_log(const char *); // Opens the schedule log.
+void write_schedule_log_header(int, unsigned long long); // Writes the header, tasks and frequency levels of the simulation that is starting.
+void log_record(int, int, int, int, float, float, float, float); // Appends a record to the schedule log.
+void log_job_record(int, int, const Job *, float, float, float, float); // Appends a record of a job to the schedule log.
+void close_schedule_log(); // Closes the schedule log.
@@ -1,6 +1,5 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include <limits.h>
 
 #include "configuration.h"
@@ -9,54 +8,103 @@
 #include "job.h"
 #include "utility.h"
 #include "freq_and_voltage.h"
+#include "event_calendar.h"
+#include "aperiodic.h"
+#include "dpm.h"
+#include "energy.h"
+#include "prediction.h"
+#include "aet_source.h"
+#include "histogram.h"
+#include "baseline.h"
+#include "report.h"
+#include "trace.h"
+#include "schedule_log.h"
+#include "segment_index.h"
+#include "checkpoint.h"
+#include "what_if.h"
+#include "overhead.h"
+#include "crpd.h"
+#include "preemption_threshold.h"
+#include "slack_reclaiming.h"
 
 // Global variables required to schedule the jobs.
 
 // Output files.
-extern FILE *output_file;
-extern FILE *statistics_file;
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
 
 // Tasks, jobs and frequency (and voltage) data.
-extern int num_tasks;
-extern Task *tasks;
-extern int num_jobs;
-extern Job *jobs;
-extern int num_freq_levels;
-extern Freq_and_voltage *freq_and_voltage;
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Level_transition *level_transitions;
 
 // Related to static frequency, current frequency and number of freq changes and calculations.
-extern int static_freq_and_voltage_index;
-extern Freq_and_voltage static_freq_and_voltage;
-Freq_and_voltage current_freq_and_voltage;
-int current_freq_and_voltage_index;
-extern long num_freq_calculations;
-extern long num_freq_changes;
+extern _Thread_local int static_freq_and_voltage_index;
+extern _Thread_local Freq_and_voltage static_freq_and_voltage;
+_Thread_local Freq_and_voltage current_freq_and_voltage;
+_Thread_local int current_freq_and_voltage_index;
+extern _Thread_local long num_freq_calculations;
+extern _Thread_local long num_freq_changes;
+
+// Related to two-level frequency splitting (the allocation window runs at the two levels around the required speed).
+_Thread_local int frequency_splitting = FREQUENCY_SPLITTING; // Whether the windows are split.
+_Thread_local int split_freq_and_voltage_index; // Lower level of the split window (-1 if the window is not split).
+_Thread_local Calendar_event *frequency_switch_event; // Switch to the lower level in the event calendar (NULL if there is none).
+_Thread_local long num_split_freq_changes; // Frequency changes caused by the splitting.
+
+// Related to frequency-change hysteresis (a lower level is only taken if the change pays for itself over the allocation window).
+_Thread_local int frequency_hysteresis = FREQUENCY_HYSTERESIS; // Whether changes to a lower level are tested first.
+_Thread_local long num_held_freq_changes; // Changes to a lower level that were held back.
+
+// Related to the prediction of execution times (the jobs are budgeted for their predicted time instead of their remaining time).
+_Thread_local int aet_prediction = AET_PREDICTION; // Whether the jobs are budgeted for their predicted time.
+_Thread_local Calendar_event *prediction_overrun_event; // Running job executing for its predicted time in the event calendar (NULL if there is none).
+
+// Related to preemption-threshold scheduling (a started job can only be preempted by the tasks of higher priority than the threshold of its task).
+_Thread_local int preemption_threshold_scheduling = PREEMPTION_THRESHOLD; // Whether started jobs are ordered at the threshold of their task.
+
+// Related to slack reclaiming (the time that finished jobs did not use lowers the frequency of the jobs of the same or lower priority).
+_Thread_local int slack_reclaiming = SLACK_RECLAIMING; // Whether the slack of finished jobs is reclaimed.
 
 // Related to the ready queue.
-Job *ready_queue;
-int num_job_in_ready_queue;
-int current_job_ready_queue_index;
-int current_job_overall_job_index;
+_Thread_local Job *ready_queue;
+_Thread_local int num_job_in_ready_queue;
+_Thread_local int current_job_ready_queue_index;
+_Thread_local int current_job_overall_job_index;
 
 // Timing parameters.
-extern long end_of_execution_time;
-float current_time;
-long next_deadline;
-float next_decision_point;
+extern _Thread_local long end_of_execution_time;
+_Thread_local float current_time;
+_Thread_local long next_deadline;
+_Thread_local float next_decision_point;
 
 // Related to statistics.
-long num_context_switches;
-long num_preemptions;
-long num_cache_impact_points;
-int prev_task_instance;
-int prev_task;
-int current_task_instance;
-int current_task;
-int prev_return_value;
-
-int event; // Event due to which scheduler was called.
-
-extern float total_dynamic_energy; // To hold total dynamic energy.
+_Thread_local long num_context_switches;
+_Thread_local long num_preemptions;
+_Thread_local long num_cache_impact_points;
+_Thread_local long num_deadline_misses;
+_Thread_local long *task_deadline_misses; // Deadline misses of every task (sorted based on period).
+_Thread_local long *task_aborted_jobs; // Jobs of every task aborted at their deadline.
+_Thread_local long *task_skipped_jobs; // Jobs of every task skipped after a miss of the previous job.
+_Thread_local int *skip_next_instance; // Whether the next job of a task is to be skipped.
+_Thread_local int simulation_aborted; // Whether the simulation stopped at its first deadline miss.
+_Thread_local int prev_task_instance;
+_Thread_local int prev_task;
+_Thread_local int current_task_instance;
+_Thread_local int current_task;
+_Thread_local int prev_return_value;
+
+_Thread_local int event; // Event due to which scheduler was called.
+_Thread_local Calendar_event *completion_event; // Completion of the running job in the event calendar (NULL if no job is running).
+
+extern _Thread_local float total_dynamic_energy; // To hold total dynamic energy.
+
+extern unsigned long long simulation_seed;
+_Thread_local int core_num; // Core being simulated by this thread (0 when there is only one core).
 
 // Functions.
 /*
@@ -69,9 +117,6 @@ start_scheduler()
     fprintf(output_file, "------------------------------------------------------------\n");
     fprintf(output_file, "Scheduler starting. (Scheduling from t=0 to t=%ld).\n\n", end_of_execution_time);
 
-    // Setting the seed before random numbers are generated.
-    srand(time(NULL));
-
     // Initialising variables before the scheduler starts.
     num_job_in_ready_queue = 0;
     ready_queue = (Job *) malloc(sizeof(Job) * num_job_in_ready_queue);
@@ -88,14 +133,62 @@ start_scheduler()
     current_freq_and_voltage_index = static_freq_and_voltage_index;
     num_freq_changes = 0;
     num_freq_calculations = 0;
+    num_split_freq_changes = 0;
+    num_held_freq_changes = 0;
+    num_deadline_misses = 0;
+    task_deadline_misses = (long *) calloc(num_tasks, sizeof(long));
+    task_aborted_jobs = (long *) calloc(num_tasks, sizeof(long));
+    task_skipped_jobs = (long *) calloc(num_tasks, sizeof(long));
+    skip_next_instance = (int *) calloc(num_tasks, sizeof(int));
+    simulation_aborted = 0;
     total_dynamic_energy = 0;
 
+    // The event calendar starts with the end of the horizon and the release of the first job. Every admitted job schedules the release of the next one.
+    init_event_calendar();
+    completion_event = NULL;
+    frequency_switch_event = NULL;
+    prediction_overrun_event = NULL;
+    split_freq_and_voltage_index = -1;
+    schedule_calendar_event(end_of_execution_time, CALENDAR_HORIZON_END, -1);
+    if (num_jobs > 0)
+        schedule_calendar_event(jobs[0].arrival_time, CALENDAR_JOB_RELEASE, 0);
+
+    // The aperiodic and sporadic jobs (if there is a server) arrive through the same event calendar.
+    init_aperiodic_jobs();
+
+    // Setting the seed before random numbers are generated.
+    seed_random(simulation_seed + core_num);
+    init_aet_sources();
+    init_crpd();
+
+    // Static, idle and sleep energy are accounted separately from the dynamic energy.
+    init_dpm();
+    init_energy_accounting();
+    init_aet_prediction();
+    init_task_histograms();
+    init_segment_index();
+    init_preemption_thresholds();
+    init_slack_reclaiming();
+
+    // The scheduler continues from a snapshot (if one is to be restored) instead of from t=0.
+    init_checkpoints();
+
+    // The trace (if this simulation is traced) starts at the static frequency.
+    char process_name[64];
+    snprintf(process_name, sizeof(process_name), "Core %d", core_num);
+    trace_metadata(core_num, process_name);
+    write_schedule_log_header(core_num, simulation_seed + core_num);
+    trace_frequency(current_time, current_freq_and_voltage.freq, current_freq_and_voltage.voltage);
+
     // Starting the scheduler.
-    scheduler(); // Since the scheduler is recursive, one call to the scheduler is enough.
+    scheduler(); // The scheduler runs from one decision point to the next till the end of execution.
+    write_final_checkpoint();
 
 
     // Once the scheduler has finished scheduling.
     free(ready_queue);
+    delete_event_calendar();
+    delete_preemption_thresholds();
 
     fprintf(output_file, "\n\nScheduler has finished scheduling.\n");
     fprintf(output_file, "\nDisclaimer: Please open the statistics file to view the statistics of the execution of the task set.\n");
@@ -110,16 +203,53 @@ start_scheduler()
 
     // Printing statistics.
     fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Random seed: %llu\n", simulation_seed + core_num);
     fprintf(statistics_file, "Total dynamic-energy consumer: %0.2f\n", total_dynamic_energy);
+    print_dpm_statistics();
+    delete_dpm();
     fprintf(statistics_file, "Weighted average percentage of execution of jobs: %0.1f\n", find_avg_percentage_execution());
     fprintf(statistics_file, "Total number of context-switches: %ld\n", num_context_switches);
     fprintf(statistics_file, "Total number of preemptions: %ld\n", num_preemptions);
     fprintf(statistics_file, "Total number of cache-impact points: %ld\n", num_cache_impact_points);
     fprintf(statistics_file, "Total number of frequency calculations: %ld\n", num_freq_calculations);
     fprintf(statistics_file, "Total number of frequency changes: %ld\n", num_freq_changes);
+    if (frequency_splitting)
+        fprintf(statistics_file, "Total number of frequency changes due to frequency splitting: %ld\n", num_split_freq_changes);
+    if (frequency_hysteresis)
+        fprintf(statistics_file, "Total number of frequency changes held back by the hysteresis: %ld\n", num_held_freq_changes);
+    fprintf(statistics_file, "Total number of deadline misses: %ld\n", num_deadline_misses);
+    print_deadline_miss_statistics();
 
     // Print job-wise statistics.
     capture_and_print_task_statistics();
+    print_task_histograms();
+    print_segment_index_statistics();
+    delete_segment_index();
+    print_residency_statistics();
+    delete_energy_accounting();
+    print_aperiodic_statistics();
+    delete_aperiodic_jobs();
+    if (aet_prediction)
+        print_prediction_statistics();
+    delete_aet_prediction();
+    print_aet_statistics();
+    print_crpd_statistics();
+    delete_crpd();
+    if (slack_reclaiming)
+        print_slack_reclaiming_statistics();
+    delete_slack_reclaiming();
+    print_what_if_statistics();
+    delete_aet_sources();
+
+    // The histograms are kept (till the jobs are deleted), so that the histograms of the cores can be merged.
+    Simulation_summary summary;
+    summarise_simulation(&summary);
+    write_json_statistics(&summary, simulation_seed + core_num, current_time);
+
+    free(task_deadline_misses);
+    free(task_aborted_jobs);
+    free(task_skipped_jobs);
+    free(skip_next_instance);
 
     return;
 }
@@ -154,26 +284,31 @@ allocate_time()
     find_next_deadline();
     float time_left = next_deadline - current_time;
 
-    float overheads = FREQUENCY_CALCULATION_OVERHEAD;
+    float overheads = find_frequency_calculation_overhead(num_job_in_ready_queue);
     if (event == 1) // Event is 1 when there is a new job arrival.
     // A new job arrival MAY cause a frequency change, but a job termination will surely not.
         overheads += FREQUENCY_CHANGE_OVERHEAD;
 
     // Jobs are already sorted based on period/priority in the ready queue.
-    // Allocating time to each task based on priority.
+    // Allocating time to each task based on priority. (The server job is allocated time for the work it can do with its budget, like any other job).
     for (int i = 0; i < num_job_in_ready_queue; i++)
     {
-        if (ready_queue[i].time_left + overheads <= time_left) // If more allocation can be done after this allocation.
+        // With prediction, a periodic job is budgeted for its predicted time (or the rest of its wcet once it overruns the prediction).
+        float demand = ready_queue[i].time_left;
+        if (aet_prediction && !is_server_task(ready_queue[i].task_num))
+            demand = find_predicted_demand(&ready_queue[i]);
+
+        if (demand + overheads <= time_left) // If more allocation can be done after this allocation.
         {
-            if (ready_queue[i].time_left > overheads) // If the time left in execution is not very small.
+            if (demand > overheads) // If the time left in execution is not very small.
             {
-                ready_queue[i].time_next_execution =  ready_queue[i].time_left - overheads;
-                time_left -= ready_queue[i].time_left - overheads;
+                ready_queue[i].time_next_execution =  demand - overheads;
+                time_left -= demand - overheads;
             }
             else
             {
-                ready_queue[i].time_next_execution = ready_queue[i].time_left;
-                time_left -= ready_queue[i].time_left;
+                ready_queue[i].time_next_execution = demand;
+                time_left -= demand;
             }
         }
         else // If this is the last non-zero allocation.
@@ -200,6 +335,10 @@ select_frequency()
     float dynamic_task_utilisation = 0;
 
     float prev_freq = current_freq_and_voltage.freq;
+    int prev_freq_and_voltage_index = current_freq_and_voltage_index;
+
+    // The split of the previous allocation window (if any) is replaced by the one of this window.
+    cancel_frequency_split();
     
     // Finding the task utilisation at the current time till the next deadline.
     for (int i = 0; i < num_job_in_ready_queue; i++)
@@ -208,6 +347,10 @@ select_frequency()
             dynamic_task_utilisation += ready_queue[i].time_next_execution;
     }
     dynamic_task_utilisation = dynamic_task_utilisation / time_left;
+
+    // The job that runs next can be slowed down by the slack that finished jobs of the same or higher priority left.
+    if (slack_reclaiming)
+        dynamic_task_utilisation = find_reclaimed_utilisation(dynamic_task_utilisation, time_left);
     
     // Based on the current task utilisation, we calculate the best fit frequency.
     if (dynamic_task_utilisation >= freq_and_voltage[num_freq_levels - 1].freq) // The case when the task utilisation is >= Fmax.
@@ -230,10 +373,20 @@ select_frequency()
         }
     }
 
-    fprintf(output_file, "Frequency calculation overhead being added. %0.2f + %0.2f = %0.2f\n", current_time, FREQUENCY_CALCULATION_OVERHEAD, current_time + FREQUENCY_CALCULATION_OVERHEAD);
+    // A change to a lower level is only made if it pays for itself (a higher level is needed to fit the work, so it is always taken).
+    if (frequency_hysteresis && current_freq_and_voltage_index < prev_freq_and_voltage_index)
+        current_freq_and_voltage_index = find_hysteresis_level(prev_freq_and_voltage_index, current_freq_and_voltage_index, dynamic_task_utilisation, time_left);
+
+    float frequency_calculation_overhead = find_frequency_calculation_overhead(num_job_in_ready_queue);
+    fprintf(output_file, "Frequency calculation overhead being added. %0.2f + %0.2f = %0.2f\n", current_time, frequency_calculation_overhead, current_time + frequency_calculation_overhead);
 
     // Adding the freq calculation overhead.
-    current_time += FREQUENCY_CALCULATION_OVERHEAD;
+    trace_slice(TRACE_OVERHEAD_TID, "overhead", "Frequency calculation", current_time, current_time + frequency_calculation_overhead);
+    trace_counter("Dynamic utilisation", current_time, dynamic_task_utilisation);
+    log_record(LOG_FREQUENCY_CALCULATION, current_freq_and_voltage_index, -1, -1, current_time, current_time, 0, dynamic_task_utilisation);
+    log_record(LOG_OVERHEAD, current_freq_and_voltage_index, LOG_FREQUENCY_CALCULATION_OVERHEAD, -1, current_time, current_time + frequency_calculation_overhead, freq_and_voltage[current_freq_and_voltage_index].dynamic_power * frequency_calculation_overhead, 0);
+    current_time += frequency_calculation_overhead;
+    add_overhead_energy(frequency_calculation_overhead);
     num_freq_calculations++;
 
     // Not every frequency calculation might lead to a frequency change.
@@ -242,10 +395,16 @@ select_frequency()
     if (prev_freq != freq_and_voltage[current_freq_and_voltage_index].freq)
     {
         current_freq_and_voltage = freq_and_voltage[current_freq_and_voltage_index];
-        fprintf(output_file, "Frequency change overhead being added. %0.2f + %0.2f = %0.2f\n", current_time, FREQUENCY_CHANGE_OVERHEAD, current_time + FREQUENCY_CHANGE_OVERHEAD);
 
-        // Adding the freq change overhead.
-        current_time += FREQUENCY_CHANGE_OVERHEAD;
+        // Adding the freq change overhead (the latency of the change between the two levels).
+        float latency = add_transition_energy(prev_freq_and_voltage_index, current_freq_and_voltage_index);
+        fprintf(output_file, "Frequency change overhead being added. %0.2f + %0.2f = %0.2f\n", current_time, latency, current_time + latency);
+        trace_instant(TRACE_OVERHEAD_TID, "Frequency change", current_time);
+        trace_slice(TRACE_OVERHEAD_TID, "overhead", "Frequency change", current_time, current_time + latency);
+        trace_frequency(current_time, current_freq_and_voltage.freq, current_freq_and_voltage.voltage);
+        log_record(LOG_FREQUENCY_CHANGE, current_freq_and_voltage_index, prev_freq_and_voltage_index, -1, current_time, current_time, 0, 0);
+        log_record(LOG_OVERHEAD, current_freq_and_voltage_index, LOG_FREQUENCY_CHANGE_OVERHEAD, -1, current_time, current_time + latency, level_transitions[prev_freq_and_voltage_index * num_freq_levels + current_freq_and_voltage_index].energy, 0);
+        current_time += latency;
         num_freq_changes++;
 
         fprintf(output_file, "Frequency change. New task utilisation at: %0.2f, frequency: %0.2f\n", dynamic_task_utilisation, current_freq_and_voltage.freq);
@@ -255,6 +414,156 @@ select_frequency()
         fprintf(output_file, "No frequency change. New task utilisation at: %0.2f, frequency: %0.2f\n", dynamic_task_utilisation, current_freq_and_voltage.freq);
     }
 
+    if (frequency_splitting)
+        find_frequency_split(dynamic_task_utilisation * time_left);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The level the core runs at, the lower level that fits the dynamic utilisation and the time left till the next deadline.
+ * Post-condition: Returns the lower level if the change to it pays for itself, or the current level otherwise.
+ *
+ * Without a release, the core runs at the lower level fl till the ready jobs finish (after that it idles, which drops the level at no cost), for
+ *      T = sum over the ready jobs of (time left + O)
+ * where O is the overheads of a decision point. If the next job is released before that, at r from now, the dynamic utilisation is then about
+ *      u' = (u * L - r + C) / min(L - r, D)
+ * where u is the dynamic utilisation, L is the time left till the next deadline, and C and D are the time left and relative deadline of the released job.
+ * If u' > fl + FREQUENCY_HYSTERESIS_BAND, the core is likely to come back up to fc at the release, so it runs at fl for only T = r and the change back up is charged as well.
+ * Otherwise, T also holds the released job (C + O). The change is made if
+ *      (Pc + Sc - Pl - Sl) * T >= E(fc -> fl) + Sl * latency(fc -> fl) (+ E(fl -> fc) + Sc * latency(fl -> fc) if the core is likely to come back up)
+ * where P and S are the dynamic and static power of a level and E is the energy of a change.
+ */
+int
+find_hysteresis_level(int current_index, int index, float utilisation, float time_left)
+{
+    float decision_point_overheads = find_decision_making_overhead(num_job_in_ready_queue) + find_frequency_calculation_overhead(num_job_in_ready_queue);
+    float busy_time = 0;
+    for (int i = 0; i < num_job_in_ready_queue; i++)
+    {
+        if (ready_queue[i].time_left > 0)
+            busy_time += ready_queue[i].time_left + decision_point_overheads;
+    }
+
+    Freq_and_voltage current = freq_and_voltage[current_index];
+    Freq_and_voltage lower = freq_and_voltage[index];
+    Level_transition down = level_transitions[current_index * num_freq_levels + index];
+    float change_energy = down.energy + lower.static_power * down.latency;
+
+    // The jobs are sorted based on arrival time, so the next job to be released is the one after the last admitted job.
+    int next_job_index = current_job_overall_job_index + 1;
+    if (next_job_index < num_jobs && jobs[next_job_index].arrival_time - current_time < busy_time)
+    {
+        Job next_job = jobs[next_job_index];
+        float release_time = next_job.arrival_time - current_time;
+        float window = time_left - release_time;
+        if (window <= 0 || next_job.absolute_deadline - next_job.arrival_time < window)
+            window = next_job.absolute_deadline - next_job.arrival_time;
+
+        float work_left = utilisation * time_left - release_time;
+        if (work_left < 0)
+            work_left = 0;
+
+        if ((work_left + next_job.time_left) / window > lower.freq + FREQUENCY_HYSTERESIS_BAND) // Likely to come back up at the release.
+        {
+            Level_transition up = level_transitions[index * num_freq_levels + current_index];
+            change_energy += up.energy + current.static_power * up.latency;
+            busy_time = release_time;
+        }
+        else
+        {
+            busy_time += next_job.time_left + decision_point_overheads;
+        }
+    }
+
+    float saved_energy = (current.dynamic_power + current.static_power - lower.dynamic_power - lower.static_power) * busy_time;
+    if (saved_energy >= change_energy)
+        return index;
+
+    fprintf(output_file, "Frequency hysteresis: The change from %0.2f to %0.2f does not pay for itself (saves %0.2f for a cost of %0.2f), so the frequency is kept.\n", current.freq, lower.freq, saved_energy, change_energy);
+    num_held_freq_changes++;
+
+    return current_index;
+}
+
+
+/*
+ * Pre-condition: The work (in units of time at Fmax) allocated till the next deadline, and the level selected for it.
+ * Post-condition: If the work can be done by running at the selected level first and then at the next lower level, the switch to the lower level is added to the event calendar.
+ *
+ * With levels fl < u <= fh around the required speed u, running for th at fh and for the rest of the window (after the frequency-change overhead) at fl does the same work when
+ *      fh * th + fl * (L - th - latency) = u * L
+ * where L is the time left till the next deadline and latency is the time taken by the change from fh to fl. Work is done as early as possible, so the higher level runs first.
+ */
+void
+find_frequency_split(float work)
+{
+    if (current_freq_and_voltage_index == 0 || work <= 0)
+        return;
+
+    float window = next_deadline - current_time;
+    float high_freq = freq_and_voltage[current_freq_and_voltage_index].freq;
+    float low_freq = freq_and_voltage[current_freq_and_voltage_index - 1].freq;
+    float low_window = window - level_transitions[current_freq_and_voltage_index * num_freq_levels + current_freq_and_voltage_index - 1].latency;
+
+    float high_time = (work - low_freq * low_window) / (high_freq - low_freq);
+    if (high_time < 0) // The lower level alone is enough after the overheads of this decision point.
+        high_time = 0;
+    if (high_time >= low_window) // No time is saved by switching.
+        return;
+
+    split_freq_and_voltage_index = current_freq_and_voltage_index - 1;
+    frequency_switch_event = schedule_calendar_event(current_time + high_time, CALENDAR_FREQUENCY_SWITCH, -1);
+
+    fprintf(output_file, "Frequency split: %0.2f from t=%0.2f to t=%0.2f, then %0.2f till t=%ld.\n", high_freq, current_time, current_time + high_time, low_freq, next_deadline);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The split allocation window has reached its switch point.
+ * Post-condition: The frequency is changed to the lower level of the window (along with the frequency-change overhead).
+ */
+void
+switch_frequency_split()
+{
+    int prev_freq_and_voltage_index = current_freq_and_voltage_index;
+    frequency_switch_event = NULL;
+    current_freq_and_voltage_index = split_freq_and_voltage_index;
+    current_freq_and_voltage = freq_and_voltage[current_freq_and_voltage_index];
+    split_freq_and_voltage_index = -1;
+
+    float latency = add_transition_energy(prev_freq_and_voltage_index, current_freq_and_voltage_index);
+    fprintf(output_file, "Frequency switch of the split window. Frequency change overhead being added. %0.2f + %0.2f = %0.2f. New frequency: %0.2f\n", current_time, latency, current_time + latency, current_freq_and_voltage.freq);
+    trace_instant(TRACE_OVERHEAD_TID, "Frequency change", current_time);
+    trace_slice(TRACE_OVERHEAD_TID, "overhead", "Frequency change", current_time, current_time + latency);
+    trace_frequency(current_time, current_freq_and_voltage.freq, current_freq_and_voltage.voltage);
+    log_record(LOG_FREQUENCY_CHANGE, current_freq_and_voltage_index, prev_freq_and_voltage_index, -1, current_time, current_time, 0, 0);
+    log_record(LOG_OVERHEAD, current_freq_and_voltage_index, LOG_FREQUENCY_CHANGE_OVERHEAD, -1, current_time, current_time + latency, level_transitions[prev_freq_and_voltage_index * num_freq_levels + current_freq_and_voltage_index].energy, 0);
+
+    current_time += latency;
+    num_freq_changes++;
+    num_split_freq_changes++;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: None.
+ * Post-condition: The pending switch of a split allocation window (if any) is removed from the event calendar.
+ */
+void
+cancel_frequency_split()
+{
+    if (frequency_switch_event)
+        cancel_calendar_event(frequency_switch_event);
+
+    frequency_switch_event = NULL;
+    split_freq_and_voltage_index = -1;
+
     return;
 }
 
@@ -289,59 +598,243 @@ find_next_deadline()
 
 
 /*
- * Pre-condition: Job queue sorted on arrival time and index of currently running job in the ready queue.
- * Post-condition: Finds the next decision point between finished execution of current job vs arrival of the next job. Returns a value to specify whether the previous job got to finish executing (return value = 1) or if the previous job was preempted by a new job (return value = 2).
+ * Pre-condition: Event calendar containing the next job release and the end of execution, and index of currently running job in the ready queue.
+ * Post-condition: Finds the next decision point between finished execution of current job vs arrival of the next job vs end of execution. Returns a value to specify whether the previous job got to finish executing (return value = 1) or if the previous job was preempted by a new job or by the end of execution (return value = 2). Returns 3 if the job keeps running, but at the second frequency of a split window. Returns 4 if the job has executed for its predicted time without finishing. Returns 5 if a deadline is missed and the miss has to be handled at the deadline (the job is aborted or the simulation stops).
  */
 int
 find_next_decision_point()
 {
-    // Checking if this is the last job to execute.
-    if ((current_job_overall_job_index != num_jobs - 1) && (current_job_overall_job_index != -1)) // If not last job and not first job.
+    int running_job_index = -1;
+
+    // If a job is running, its completion competes with the other events in the calendar.
+    if (num_job_in_ready_queue > 0 && current_job_ready_queue_index >= 0 && current_job_ready_queue_index < num_job_in_ready_queue)
+    {
+        Job job = ready_queue[current_job_ready_queue_index];
+        running_job_index = job.job_index;
+        completion_event = schedule_calendar_event(current_time + job.time_left, CALENDAR_JOB_COMPLETION, job.job_index);
+
+        // A job that is going to overrun its prediction is a decision point once it has executed for its predicted time.
+        float predicted_time_left = job.predicted_time - job.time_executed;
+        if (aet_prediction && !is_server_task(job.task_num) && predicted_time_left > PREDICTION_EPSILON && predicted_time_left < job.time_left)
+            prediction_overrun_event = schedule_calendar_event(current_time + predicted_time_left, CALENDAR_PREDICTION_OVERRUN, job.job_index);
+    }
+
+    // Deadline checks are not decision points. They are handled as soon as it is known that they happen before the next decision point.
+    Calendar_event *next = peek_calendar_event();
+    while (next->type == CALENDAR_DEADLINE_CHECK)
     {
-        if (num_job_in_ready_queue == 0) // If the ready queue is empty.
+        Calendar_event deadline_check = pop_calendar_event();
+        if (check_deadline(deadline_check.job_index, running_job_index))
         {
-            next_decision_point = jobs[current_job_overall_job_index + 1].arrival_time;
-            return 2; // Interrupted by job arrival.
+            next_decision_point = deadline_check.time;
+            if (completion_event)
+                cancel_calendar_event(completion_event);
+            if (prediction_overrun_event)
+                cancel_calendar_event(prediction_overrun_event);
+            completion_event = NULL;
+            prediction_overrun_event = NULL;
+            return 5; // Misses its deadline.
         }
+        next = peek_calendar_event();
+    }
 
-        next_decision_point = (current_time + ready_queue[current_job_ready_queue_index].time_left < jobs[current_job_overall_job_index + 1].arrival_time) ? current_time + ready_queue[current_job_ready_queue_index].time_left : jobs[current_job_overall_job_index + 1].arrival_time;
+    next_decision_point = next->time;
 
-        if (current_time + ready_queue[current_job_ready_queue_index].time_left < jobs[current_job_overall_job_index + 1].arrival_time)
-            return 1; // Finishes execution.
-        else
-            return 2; // Interrupted by job arrival.
+    if (next->type == CALENDAR_JOB_COMPLETION)
+    {
+        pop_calendar_event();
+        completion_event = NULL;
+        if (prediction_overrun_event)
+            cancel_calendar_event(prediction_overrun_event);
+        prediction_overrun_event = NULL;
+        return 1; // Finishes execution.
+    }
+
+    if (next->type == CALENDAR_PREDICTION_OVERRUN)
+    {
+        pop_calendar_event();
+        prediction_overrun_event = NULL;
+        cancel_calendar_event(completion_event);
+        completion_event = NULL;
+        return 4; // Overruns its prediction.
+    }
+
+    if (prediction_overrun_event)
+    {
+        cancel_calendar_event(prediction_overrun_event);
+        prediction_overrun_event = NULL;
     }
-    else if (current_job_overall_job_index == -1) // If its the first job.
+
+    // The running job (if any) does not finish before the next release or the end of execution.
+    if (completion_event)
     {
-        next_decision_point = jobs[current_job_overall_job_index + 1].arrival_time;
-        return 2; // Interrupted by job arrival.
+        cancel_calendar_event(completion_event);
+        completion_event = NULL;
     }
-    else // If last job.
+
+    if (next->type == CALENDAR_FREQUENCY_SWITCH)
     {
-        if (current_job_overall_job_index >= num_jobs - 1 && num_job_in_ready_queue == 0) // If the ready queue is empty.
+        pop_calendar_event();
+        return 3; // Switches frequency.
+    }
+
+    return 2; // Interrupted by job arrival (or end of execution).
+}
+
+
+/*
+ * Pre-condition: A job whose absolute deadline has just been reached, and the job that is running (-1 if none is running).
+ * Post-condition: Reports and counts the job if it has not finished by its deadline, and applies the overrun policy to it. Returns 1 if the miss has to be handled at the deadline (the running job is aborted or the simulation stops), 0 otherwise.
+ *
+ * A job that is not running is aborted right away, as it cannot run before the next decision point anyway.
+ */
+int
+check_deadline(int job_index, int running_job_index)
+{
+    // Jobs in the jobs array are marked as not alive when they complete. (The server job can miss its deadline only by serving the jobs that arrived late in its period).
+    if (!jobs[job_index].alive || jobs[job_index].aborted || is_server_task(jobs[job_index].task_num))
+        return 0;
+
+    num_deadline_misses++;
+    task_deadline_misses[jobs[job_index].sorted_task_num]++;
+    fprintf(output_file, "Job J%d,%d missed its deadline at t=%ld.\n", jobs[job_index].task_num, jobs[job_index].instance_num, jobs[job_index].absolute_deadline);
+
+    char name[64];
+    snprintf(name, sizeof(name), "J%d,%d missed its deadline", jobs[job_index].task_num, jobs[job_index].instance_num);
+    trace_instant(TRACE_TASK_TID(jobs[job_index].task_num), name, jobs[job_index].absolute_deadline);
+    log_job_record(LOG_DEADLINE_MISS, current_freq_and_voltage_index, &jobs[job_index], jobs[job_index].absolute_deadline, jobs[job_index].absolute_deadline, 0, 0);
+
+    if (OVERRUN_POLICY == OVERRUN_SKIP_NEXT)
+        skip_next_instance[jobs[job_index].sorted_task_num] = 1;
+
+    if (EARLY_ABORT_ON_MISS)
+    {
+        simulation_aborted = 1;
+        return 1;
+    }
+
+    if (OVERRUN_POLICY == OVERRUN_ABORT_JOB)
+    {
+        if (job_index == running_job_index)
+            return 1;
+
+        for (int i = 0; i < num_job_in_ready_queue; i++)
         {
-            next_decision_point = end_of_execution_time;
-            return 2; // Interrupted by job arrival.
+            if (ready_queue[i].job_index == job_index)
+            {
+                abort_job(i);
+                break;
+            }
         }
+    }
+
+    return 0;
+}
+
+
+/*
+ * Pre-condition: The index of a job in the ready queue that has missed its deadline.
+ * Post-condition: Removes the job from the ready queue without completing it.
+ */
+void
+abort_job(int ready_queue_index)
+{
+    int i = ready_queue[ready_queue_index].job_index;
+    jobs[i].aborted = true;
+    jobs[i].time_executed = ready_queue[ready_queue_index].time_executed;
+    jobs[i].dynamic_energy_consumed = ready_queue[ready_queue_index].dynamic_energy_consumed;
+    task_aborted_jobs[jobs[i].sorted_task_num]++;
+
+    fprintf(output_file, "Job J%d,%d: Aborted at its deadline after executing for %0.2f of %0.2f.\n", jobs[i].task_num, jobs[i].instance_num, ready_queue[ready_queue_index].time_executed, ready_queue[ready_queue_index].aet);
+
+    for (int j = ready_queue_index + 1; j < num_job_in_ready_queue; j++)
+    {
+        ready_queue[j - 1] = ready_queue[j];
+    }
 
-        float overheads = FREQUENCY_CALCULATION_OVERHEAD;
-        if (event == 1) // Event is 1 when there is a new job arrival.
-        // A new job arrival MAY cause a frequency change, but a job termination will surely not.
-            overheads += FREQUENCY_CHANGE_OVERHEAD;
+    num_job_in_ready_queue--;
+    ready_queue = (Job *) realloc(ready_queue, sizeof(Job) * num_job_in_ready_queue);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The deadline misses after the scheduler has finished.
+ * Post-condition: Prints the deadline misses (along with the aborted and skipped jobs) of every task onto the statistics file.
+ */
+void
+print_deadline_miss_statistics()
+{
+    if (simulation_aborted)
+        fprintf(statistics_file, "Simulation aborted at the first deadline miss at t=%0.2f.\n", current_time);
+
+    fprintf(statistics_file, "Deadline misses per task: ");
+    for (int i = 0; i < num_tasks; i++)
+        fprintf(statistics_file, "Task-%d: %ld, ", tasks[i].task_num, task_deadline_misses[i]);
+    fprintf(statistics_file, "\n");
+
+    if (OVERRUN_POLICY == OVERRUN_ABORT_JOB)
+    {
+        fprintf(statistics_file, "Aborted jobs per task: ");
+        for (int i = 0; i < num_tasks; i++)
+            fprintf(statistics_file, "Task-%d: %ld, ", tasks[i].task_num, task_aborted_jobs[i]);
+        fprintf(statistics_file, "\n");
+    }
+    else if (OVERRUN_POLICY == OVERRUN_SKIP_NEXT)
+    {
+        fprintf(statistics_file, "Skipped jobs per task: ");
+        for (int i = 0; i < num_tasks; i++)
+            fprintf(statistics_file, "Task-%d: %ld, ", tasks[i].task_num, task_skipped_jobs[i]);
+        fprintf(statistics_file, "\n");
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: Event calendar containing the next job release.
+ * Post-condition: All the jobs that have arrived till the current time are added to the ready queue. Returns 1 if at least one job arrived, 0 otherwise.
+ */
+int
+admit_arrived_jobs()
+{
+    int arrived = 0;
 
-        if (ready_queue[current_job_ready_queue_index].time_left + overheads < end_of_execution_time)
+    Calendar_event *next = peek_calendar_event();
+    while (next && next->type != CALENDAR_HORIZON_END && next->time <= current_time)
+    {
+        Calendar_event calendar_event = pop_calendar_event();
+
+        if (calendar_event.type == CALENDAR_JOB_RELEASE)
         {
-            next_decision_point += ready_queue[current_job_ready_queue_index].time_left + FREQUENCY_CALCULATION_OVERHEAD + FREQUENCY_CHANGE_OVERHEAD;
-            return 1; // Finishes execution.
+            add_job(); // Whenever a new job arrives, the job gets sorted into its place in the ready queue.
+            arrived = 1;
+
+            // The jobs are sorted based on arrival time, so only the release of the next job has to be in the calendar.
+            if (calendar_event.job_index + 1 < num_jobs)
+                schedule_calendar_event(jobs[calendar_event.job_index + 1].arrival_time, CALENDAR_JOB_RELEASE, calendar_event.job_index + 1);
         }
-        else
+        else if (calendar_event.type == CALENDAR_DEADLINE_CHECK) // No job is running at a decision point.
         {
-            next_decision_point = end_of_execution_time;
-            return 2; // Interrupted by job arrival.
+            check_deadline(calendar_event.job_index, -1);
+        }
+        else if (calendar_event.type == CALENDAR_APERIODIC_ARRIVAL)
+        {
+            aperiodic_job_arrival(calendar_event.job_index);
+            arrived = 1;
         }
+        else if (calendar_event.type == CALENDAR_SERVER_REPLENISHMENT)
+        {
+            server_replenishment(calendar_event.job_index);
+            arrived = 1;
+        }
+
+        next = peek_calendar_event();
     }
 
-    // Error if control reaches here.
+    return arrived;
 }
 
 
@@ -352,12 +845,11 @@ find_next_decision_point()
 void
 find_execution_time_periodic_job()
 {
-    // Actual execution time = (50 to 100)% of the worst-case execution time.
-    float aet = rand() % (100 - MIN_PERCENT_EXECUTION);
-    aet = (aet + MIN_PERCENT_EXECUTION) / 100;
-    aet = aet * ready_queue[num_job_in_ready_queue - 1].wcet;
+    // Actual execution time from the model of the task (by default, (50 to 100)% of the worst-case execution time).
+    float aet = find_actual_execution_time(ready_queue[num_job_in_ready_queue - 1].sorted_task_num, ready_queue[num_job_in_ready_queue - 1].wcet);
     ready_queue[num_job_in_ready_queue - 1].aet = aet;
     ready_queue[num_job_in_ready_queue - 1].time_left = aet;
+    log_job_record(LOG_JOB_RELEASE, current_freq_and_voltage_index, &ready_queue[num_job_in_ready_queue - 1], ready_queue[num_job_in_ready_queue - 1].arrival_time, ready_queue[num_job_in_ready_queue - 1].absolute_deadline, 0, aet);
 
     fprintf(output_file, "Job J%d,%d: Execution time left to finish: %0.2f\n", ready_queue[num_job_in_ready_queue - 1].task_num, ready_queue[num_job_in_ready_queue - 1].instance_num, ready_queue[num_job_in_ready_queue - 1].aet);
 
@@ -367,7 +859,7 @@ find_execution_time_periodic_job()
 
 /*
  * Pre-condition: An unsorted ready queue, unsorted only because of the last element.
- * Post-condition: Puts the last element into the right place based on the period of the jobs.
+ * Post-condition: Puts the last element into the right place based on the period of the jobs (or, with preemption-threshold scheduling, on their priority in the ready queue).
  */
 void
 insert_job_ready_queue()
@@ -379,7 +871,20 @@ insert_job_ready_queue()
 
     // Insertion sort for just one element.
     int i = num_job_in_ready_queue - 2;
-    while (i >= 0 && (tasks[jobs[i].sorted_task_num].period > tasks[job_to_insert.sorted_task_num].period || (tasks[jobs[i].sorted_task_num].period == tasks[job_to_insert.sorted_task_num].period && jobs[i].absolute_deadline > job_to_insert.absolute_deadline)))
+    if (preemption_threshold_scheduling) // A started job is ahead of the jobs that are not of higher priority than the threshold of its task.
+    {
+        int priority = find_ready_queue_priority(&job_to_insert);
+        while (i >= 0 && (find_ready_queue_priority(&ready_queue[i]) > priority || (find_ready_queue_priority(&ready_queue[i]) == priority && ready_queue[i].absolute_deadline > job_to_insert.absolute_deadline)))
+        {
+            ready_queue[i + 1] = ready_queue[i];
+            i--;
+        }
+        ready_queue[i + 1] = job_to_insert;
+
+        return;
+    }
+
+    while (i >= 0 && (tasks[ready_queue[i].sorted_task_num].period > tasks[job_to_insert.sorted_task_num].period || (tasks[ready_queue[i].sorted_task_num].period == tasks[job_to_insert.sorted_task_num].period && ready_queue[i].absolute_deadline > job_to_insert.absolute_deadline)))
     {
         ready_queue[i + 1] = ready_queue[i];
         i--;
@@ -407,16 +912,47 @@ add_job()
 
     // Changing the meta data of the job and the ready queue.
     job.admitted = true;
+    jobs[current_job_overall_job_index].admitted = true;
+
+    // The job after one that missed its deadline is skipped (with the skip-next overrun policy).
+    if (skip_next_instance[job.sorted_task_num])
+    {
+        skip_next_instance[job.sorted_task_num] = 0;
+        jobs[current_job_overall_job_index].aborted = true;
+        task_skipped_jobs[job.sorted_task_num]++;
+        fprintf(output_file, "Job J%d,%d: Skipped as the previous job of the task missed its deadline.\n", job.task_num, job.instance_num);
+
+        return;
+    }
+
+    // The execution time of a server job is the work waiting for it (a server job with no work does not enter the ready queue).
+    if (is_server_task(job.task_num))
+    {
+        if (release_server_job(&job))
+        {
+            num_job_in_ready_queue++;
+            ready_queue = (Job *) realloc(ready_queue, sizeof(Job) * num_job_in_ready_queue);
+            ready_queue[num_job_in_ready_queue - 1] = job;
+            insert_job_ready_queue();
+        }
+
+        return;
+    }
+
     num_job_in_ready_queue++;
     ready_queue = (Job *) realloc(ready_queue, sizeof(Job) * num_job_in_ready_queue);
     ready_queue[num_job_in_ready_queue - 1] = job;
 
     // Find the execution time of the job.
     find_execution_time_periodic_job();
+    ready_queue[num_job_in_ready_queue - 1].predicted_time = predict_execution_time(job.sorted_task_num);
 
     // To add the job into the right place in the ready queue.
     insert_job_ready_queue();
 
+    // The deadline of the job is checked once it is reached.
+    schedule_calendar_event(job.absolute_deadline, CALENDAR_DEADLINE_CHECK, job.job_index);
+
     return;
 }
 
@@ -435,25 +971,36 @@ complete_job()
     if (current_job_overall_job_index >= num_jobs - 1 && num_job_in_ready_queue == 0) // If the job queues are empty.
         return;
 
-    // Finding and adding the dynamic power consumed by the execution of this job to the total.
-    add_dynamic_energy();
+    // A completion is a decision point, so the split of the current window is no longer needed.
+    cancel_frequency_split();
 
     fprintf(output_file, "Job J%d,%d: Finished execution at t=%0.2f. Dynamic energy consumed: %0.2f.\n", ready_queue[current_job_ready_queue_index].task_num, ready_queue[current_job_ready_queue_index].instance_num, current_time, ready_queue[current_job_ready_queue_index].dynamic_energy_consumed);
 
-    // Searching for the same job in the jobs queue so as to update it with run-time metadata.
-    for (int i = 0; i < num_jobs; i++)
+    // Updating the same job in the jobs queue with run-time metadata.
+    int i = ready_queue[current_job_ready_queue_index].job_index;
+    jobs[i].finish_time = current_time;
+    jobs[i].alive = false;
+    jobs[i].execution_freq_index = current_freq_and_voltage_index;
+    if (is_server_task(jobs[i].task_num)) // A deferrable or sporadic server job can run again in its period, so its execution is accumulated.
     {
-        if (jobs[i].task_num == ready_queue[current_job_ready_queue_index].task_num && jobs[i].instance_num == ready_queue[current_job_ready_queue_index].instance_num)
-        {
-            jobs[i].finish_time = current_time;
-            jobs[i].time_executed = ready_queue[current_job_ready_queue_index].aet;
-            jobs[i].aet = ready_queue[current_job_ready_queue_index].aet;
-            jobs[i].alive = false;
-            jobs[i].execution_freq_index = current_freq_and_voltage_index;
-            jobs[i].dynamic_energy_consumed = ready_queue[current_job_ready_queue_index].dynamic_energy_consumed;
-
-            break;
-        }
+        jobs[i].time_executed += ready_queue[current_job_ready_queue_index].aet;
+        jobs[i].aet += ready_queue[current_job_ready_queue_index].aet;
+        jobs[i].dynamic_energy_consumed += ready_queue[current_job_ready_queue_index].dynamic_energy_consumed;
+        complete_server_job();
+    }
+    else
+    {
+        jobs[i].time_executed = ready_queue[current_job_ready_queue_index].aet;
+        jobs[i].aet = ready_queue[current_job_ready_queue_index].aet;
+        jobs[i].dynamic_energy_consumed = ready_queue[current_job_ready_queue_index].dynamic_energy_consumed;
+        log_job_record(LOG_JOB_COMPLETION, current_freq_and_voltage_index, &jobs[i], jobs[i].arrival_time, current_time, jobs[i].dynamic_energy_consumed, jobs[i].aet);
+        if (aet_prediction)
+            update_aet_prediction(jobs[i].sorted_task_num, ready_queue[current_job_ready_queue_index].predicted_time, jobs[i].aet);
+        if (slack_reclaiming)
+            donate_slack(&ready_queue[current_job_ready_queue_index]);
+
+        float response_time = current_time - jobs[i].arrival_time;
+        add_job_histograms(jobs[i].sorted_task_num, response_time, response_time - jobs[i].aet, current_time - jobs[i].absolute_deadline);
     }
 
     // Shifting the jobs in the ready queue by 1 position as the job that finished has to be overwritten.
@@ -492,40 +1039,79 @@ run_job()
     if ((prev_task != -1) && ((current_task != prev_task) || (current_task_instance != prev_task_instance && current_task == prev_task)))
     {
         num_context_switches++;
+        log_record(LOG_CONTEXT_SWITCH, current_freq_and_voltage_index, ready_queue[current_job_ready_queue_index].sorted_task_num, current_task_instance, current_time, current_time, 0, prev_task != current_task);
     }
+    else if (prev_task != current_task) // The first job is a cache impact point as well.
+        log_record(LOG_CACHE_IMPACT_POINT, current_freq_and_voltage_index, ready_queue[current_job_ready_queue_index].sorted_task_num, current_task_instance, current_time, current_time, 0, 0);
 
     // A preemption is when due to the arrival of a new job the previous one was stopped, but the job to continue executing is not the previous one.
     if ((prev_return_value == 2) && ((current_task != prev_task) || (current_task_instance != prev_task_instance && current_task == prev_task))) // If there was a preemption when the latest job arrived to the ready queue.
     {
         fprintf(output_file, "Job J%d,%d was preempted. Preemption overhead: %0.2f + %0.2f = %0.2f\n", prev_task, prev_task_instance, current_time, PREEMPTION_OVERHEAD, current_time + PREEMPTION_OVERHEAD);
+
+        char name[64];
+        snprintf(name, sizeof(name), "J%d,%d preempted", prev_task, prev_task_instance);
+        trace_instant(TRACE_TASK_TID(prev_task), name, current_time);
+        trace_slice(TRACE_OVERHEAD_TID, "overhead", "Preemption", current_time, current_time + PREEMPTION_OVERHEAD);
+        log_record(LOG_PREEMPTION, current_freq_and_voltage_index, -1, prev_task_instance, current_time, current_time, 0, prev_task);
+        log_record(LOG_OVERHEAD, current_freq_and_voltage_index, LOG_PREEMPTION_OVERHEAD, -1, current_time, current_time + PREEMPTION_OVERHEAD, freq_and_voltage[current_freq_and_voltage_index].dynamic_power * PREEMPTION_OVERHEAD, 0);
         current_time += PREEMPTION_OVERHEAD;
+        add_overhead_energy(PREEMPTION_OVERHEAD);
         num_preemptions++;
     }
 
     // A cache impact point is one where the cache does not have any data relating to the new job being executed. Not all context switches result in cache impact point as two jobs of the same task can execute one after the other and this would not be a cache impact point as jobs of the same task have the same code section and mostly the same data section in general.
+    // With the CRPD model, the task reloads its useful blocks that were evicted since it last ran.
     if (prev_task != current_task) // A cache impact point can happen even when there was no preemption, but a voluntary context switch.
-            num_cache_impact_points++;
+    {
+        num_cache_impact_points++;
+        charge_cache_reload(ready_queue[current_job_ready_queue_index].sorted_task_num);
+    }
 
     
-    // Finding the next execution time.
-    int return_value = find_next_decision_point(); 
-    float execution_time = next_decision_point - current_time;
-
-    if (next_decision_point > end_of_execution_time)
+    int return_value;
+    do // The job runs in more than one segment only if its allocation window is split between two frequencies.
     {
-        next_decision_point = end_of_execution_time;
-        execution_time = end_of_execution_time - current_time;
-    }
+        // Finding the next execution time.
+        return_value = find_next_decision_point();
+        float execution_time = next_decision_point - current_time;
+
+        if (next_decision_point > end_of_execution_time)
+        {
+            next_decision_point = end_of_execution_time;
+            execution_time = end_of_execution_time - current_time;
+        }
+
+        if (execution_time < 0) // The overheads of this decision point went past the next event, so the job does not run before it is handled.
+        {
+            next_decision_point = current_time;
+            execution_time = 0;
+        }
+
+        // Updating meta-data.
+        ready_queue[current_job_ready_queue_index].time_executed += execution_time;
+        ready_queue[current_job_ready_queue_index].time_next_execution -= execution_time;
+        ready_queue[current_job_ready_queue_index].time_left -= execution_time;
+
+        // Every segment is priced at the frequency and voltage it ran at.
+        add_dynamic_energy(execution_time);
 
-    // Updating meta-data.
-    ready_queue[current_job_ready_queue_index].time_executed += execution_time;
-    ready_queue[current_job_ready_queue_index].time_next_execution -= execution_time;
-    ready_queue[current_job_ready_queue_index].time_left -= execution_time;
+        // The server executes the waiting aperiodic and sporadic jobs.
+        if (is_server_task(current_task))
+            serve_aperiodic_jobs(current_time, execution_time);
 
-    fprintf(output_file, "Job J%d,%d: Executed from t=%0.2f to t=%0.2f. Time left after current execution: %0.2f\n", ready_queue[current_job_ready_queue_index].task_num, ready_queue[current_job_ready_queue_index].instance_num, current_time, next_decision_point, ready_queue[current_job_ready_queue_index].aet - ready_queue[current_job_ready_queue_index].time_executed);
+        trace_job_slice(TRACE_TASK_TID(current_task), &ready_queue[current_job_ready_queue_index], current_time, next_decision_point, current_freq_and_voltage.freq);
+        log_job_record(LOG_JOB_SEGMENT, current_freq_and_voltage_index, &ready_queue[current_job_ready_queue_index], current_time, next_decision_point, freq_and_voltage[current_freq_and_voltage_index].dynamic_power * execution_time, 0);
+        add_indexed_segment(ready_queue[current_job_ready_queue_index].sorted_task_num, ready_queue[current_job_ready_queue_index].instance_num, current_freq_and_voltage_index, current_time, next_decision_point);
+        fprintf(output_file, "Job J%d,%d: Executed from t=%0.2f to t=%0.2f. Time left after current execution: %0.2f\n", ready_queue[current_job_ready_queue_index].task_num, ready_queue[current_job_ready_queue_index].instance_num, current_time, next_decision_point, ready_queue[current_job_ready_queue_index].aet - ready_queue[current_job_ready_queue_index].time_executed);
 
-    // Updating current time.
-    current_time = next_decision_point;
+        // Updating current time.
+        current_time = next_decision_point;
+
+        if (return_value == 3 && current_time < end_of_execution_time)
+            switch_frequency_split();
+    }
+    while (return_value == 3 && current_time < end_of_execution_time);
 
     // Check to see if the job could not finish on time before the simulation ended.
     if (current_time >= end_of_execution_time && ready_queue[current_job_ready_queue_index].time_left != 0)
@@ -546,6 +1132,18 @@ run_job()
     {
         fprintf(output_file, "Job J%d,%d was interrupted by a new job arrival at t=%0.2f.\n", ready_queue[current_job_ready_queue_index].task_num, ready_queue[current_job_ready_queue_index].instance_num, current_time);
     }
+    else if (return_value == 4) // If the job overran its prediction, the frequency is selected again with the rest of its wcet.
+    {
+        add_prediction_overrun(&ready_queue[current_job_ready_queue_index]);
+        return_value = 2; // A job released at the same time can still preempt it.
+    }
+    else if (return_value == 5) // If a deadline was missed, the running job is aborted (unless the simulation stops).
+    {
+        cancel_frequency_split();
+        if (!simulation_aborted)
+            abort_job(current_job_ready_queue_index);
+        return_value = 1; // The job leaves the core as if it had finished.
+    }
 
     // Updating previous task data to be used for next job execution to find preemption, context switches and cache impact points.
     prev_task = current_task;
@@ -610,124 +1208,114 @@ print_finished_jobs()
 
 
 /*
- * Pre-condition: A variable containing the previous total dynamic power, and the job that just executed in the ready queue.
- * Post-condition: Updates the total dynamic power by adding the dynamic power consumer by the latest job that executed.
+ * Pre-condition: A variable containing the previous total dynamic power, and the length of the latest execution of the job in the ready queue.
+ * Post-condition: Updates the total dynamic power by adding the dynamic power consumer by the latest execution of the job.
  */
 void
-add_dynamic_energy()
+add_dynamic_energy(float execution_time)
 {
-    Job job = ready_queue[current_job_ready_queue_index];
-
-    // Finding the freq and voltage at which the current job executed.
-    float execution_freq = freq_and_voltage[current_freq_and_voltage_index].freq;
-    float execution_voltage = freq_and_voltage[current_freq_and_voltage_index].voltage;
-
-    // Dynamic power consumed = v * v * f * c. (Let c = 1 is constant).
+    // Dynamic power consumed = v * v * f * c (Let c = 1 is constant), unless the measured power of the level is given in the frequency input file.
     // Dynamic energy consumed = Dynamic power * time.
-    // Dynamic energy = v * v * f * time.
-    float dynamic_energy = execution_voltage * execution_voltage * execution_freq * job.time_executed;
+    // The power of every level is precomputed, so this is one multiplication per segment.
+    float dynamic_energy = freq_and_voltage[current_freq_and_voltage_index].dynamic_power * execution_time;
 
     total_dynamic_energy += dynamic_energy;
 
     ready_queue[current_job_ready_queue_index].dynamic_energy_consumed += dynamic_energy;
+    add_residency(ready_queue[current_job_ready_queue_index].sorted_task_num, current_freq_and_voltage_index, execution_time, dynamic_energy);
 
     return;
 }
 
 
 /*
- * Pre-condition: Ready queue, list of jobs yet to arrive, next deadline and next decision points.
+ * Pre-condition: Ready queue, event calendar containing the next job release, next deadline and next decision points.
  * Post-condition: Adds, runs and completes jobs in the right order of priority of RM. Also adds to the total dynamic energy consumed.
  */
 void
 scheduler()
 {
-    // Basic checks before proceeding further.
-    if (current_time >= end_of_execution_time) // If the maximum time of execution has been reached.
-    {
-        current_time = end_of_execution_time;
-        return;
-    }
-
-    if (num_job_in_ready_queue == 0 && current_job_overall_job_index >= num_jobs - 1) // If all the jobs are completed.
-    {
-        find_next_decision_point();
-        find_next_deadline();
-        current_time = next_decision_point;
-        return;
-    }
-
-    event = 2; // Event is 2 when scheduler is called only due to a job completion.
-
-    // Adding jobs to the ready queue.
+    // Every iteration handles one decision point.
     while (1)
     {
-        // If the jobs are done, then we stop searching.
-        if (current_job_overall_job_index >= num_jobs - 1)
+        // Basic checks before proceeding further.
+        if (current_time >= end_of_execution_time) // If the maximum time of execution has been reached.
         {
-            break;
+            current_time = end_of_execution_time;
+            return;
         }
 
-        // If a job has arrived.
-        if (jobs[current_job_overall_job_index + 1].admitted == false && current_time >= jobs[current_job_overall_job_index + 1].arrival_time) // Since jobs queue is sorted based on arrival time.
+        if (simulation_aborted) // If the simulation stops at its first deadline miss.
         {
-            event = 1; // Event is 1 when scheduler is called due to a job arrival.
-            add_job(); // Whenever a new job arrives, the job gets sorted into its place in the ready queue.
+            fprintf(output_file, "\n\nScheduler aborted at the first deadline miss at t=%0.2f.\n", current_time);
+            return;
         }
-        else // If no more jobs are left.
+
+        // A snapshot of the whole state is taken (if one is due) before the decision point is handled.
+        if (take_due_checkpoint())
+            return; // A what-if simulation is back on the schedule of the base run.
+
+        if (num_job_in_ready_queue == 0 && current_job_overall_job_index >= num_jobs - 1) // If all the jobs are completed.
         {
-            fprintf(output_file, "\n");
-            break;
+            find_next_decision_point();
+            find_next_deadline();
+            idle_core(current_time, next_decision_point);
+            current_time = next_decision_point;
+            return;
         }
-    }
 
-    // If the end of execution time (which is equal to min(3*hyperperiod, first inphase time + hyperperiod)) is reached, then we stop scheduling.
-    // If the ready queue is empty and all jobs are done, then the scheduler can stop executing.
-    if ((current_time >= end_of_execution_time) || (num_job_in_ready_queue == 0 && current_job_overall_job_index == num_jobs - 1))
-    {
-        fprintf(output_file, "\n\nScheduler has finished.\n");
-        return;
-    }
+        event = 2; // Event is 2 when scheduler is called only due to a job completion.
 
-    // Checking if the ready queue is empty. Have to run idle job if it is.
-    if (num_job_in_ready_queue == 0)
-    {
-        // Finding the min freq and voltage possible to run the idle job.
-        current_freq_and_voltage_index = 0; // Since the frequencies and voltages are sorted.
-        current_freq_and_voltage = freq_and_voltage[0];
+        // Adding jobs to the ready queue.
+        if (admit_arrived_jobs())
+            event = 1; // Event is 1 when scheduler is called due to a job arrival.
+        fprintf(output_file, "\n");
 
-        find_next_decision_point();
+        // If the end of execution time (which is equal to min(3*hyperperiod, first inphase time + hyperperiod)) is reached, then we stop scheduling.
+        // If the ready queue is empty and all jobs are done, then the scheduler can stop executing.
+        if ((current_time >= end_of_execution_time) || (num_job_in_ready_queue == 0 && current_job_overall_job_index == num_jobs - 1))
+        {
+            fprintf(output_file, "\n\nScheduler has finished.\n");
+            return;
+        }
 
-        fprintf(output_file, "Idle job running at lowest frequency and voltage from t=%0.2f to %0.2f.\n", current_time, next_decision_point);
+        // Checking if the ready queue is empty. Have to run idle job if it is.
+        if (num_job_in_ready_queue == 0)
+        {
+            // Finding the min freq and voltage possible to run the idle job.
+            if (current_freq_and_voltage_index != 0)
+                trace_frequency(current_time, freq_and_voltage[0].freq, freq_and_voltage[0].voltage);
+            current_freq_and_voltage_index = 0; // Since the frequencies and voltages are sorted.
+            current_freq_and_voltage = freq_and_voltage[0];
 
-        current_time = next_decision_point;
-        
-        if (num_job_in_ready_queue == 0 && current_job_overall_job_index >= num_jobs - 1) // If the final job has completed.
-            return;
-        else
-            scheduler();
-    }
-    
-    // These checks make sure that none of the overhead times are added once the simulation time is done.
-    if (current_time >= end_of_execution_time)
-        return;
+            int return_value = find_next_decision_point();
 
-    if (num_job_in_ready_queue == 0 && current_job_overall_job_index >= num_jobs - 1) // If the final job has completed.
-        return;
+            // The core can stay idle past the next job release if the release is procrastinated. The releases in between are handled together when it wakes up. (A deadline miss that stops the simulation is handled right away).
+            float wake_up_time = (return_value == 5) ? next_decision_point : find_wake_up_time(next_decision_point);
 
-    fprintf(output_file, "Decision making overhead being added. %0.2f + %0.2f = %0.2f\n", current_time, DECISION_MAKING_OVERHEAD, current_time + DECISION_MAKING_OVERHEAD);
-    // Adding the decisioin making time.
-    current_time += DECISION_MAKING_OVERHEAD;
+            fprintf(output_file, "Idle job running at lowest frequency and voltage from t=%0.2f to %0.2f.\n", current_time, wake_up_time);
 
-    // DVFS part.
-    allocate_time();
-    select_frequency();
+            idle_core(current_time, wake_up_time);
+            current_time = wake_up_time;
 
-    // All the jobs that run from the ready queue will be from index 0 of the ready queue as the ready queue is sorted based on priority (which is the period in case of RM).
-    current_job_ready_queue_index = 0;
-    run_job();
-    
-    scheduler(); // Recursively calling the scheduler to run the next job.
+            continue; // The next decision point is handled like any other.
+        }
 
-    return;
+        // The decision making overhead grows with the number of ready jobs (unless the overheads are constant).
+        float decision_making_overhead = find_decision_making_overhead(num_job_in_ready_queue);
+        fprintf(output_file, "Decision making overhead being added. %0.2f + %0.2f = %0.2f\n", current_time, decision_making_overhead, current_time + decision_making_overhead);
+        // Adding the decisioin making time.
+        trace_slice(TRACE_OVERHEAD_TID, "overhead", "Decision making", current_time, current_time + decision_making_overhead);
+        log_record(LOG_OVERHEAD, current_freq_and_voltage_index, LOG_DECISION_MAKING_OVERHEAD, -1, current_time, current_time + decision_making_overhead, freq_and_voltage[current_freq_and_voltage_index].dynamic_power * decision_making_overhead, 0);
+        current_time += decision_making_overhead;
+        add_overhead_energy(decision_making_overhead);
+
+        // DVFS part.
+        allocate_time();
+        select_frequency();
+
+        // All the jobs that run from the ready queue will be from index 0 of the ready queue as the ready queue is sorted based on priority (which is the period in case of RM).
+        current_job_ready_queue_index = 0;
+        run_job();
+    }
 }
@@ -16,4 +16,12 @@ void allocate_time(); // Allocates time (available till the next deadline) to jo
 void select_frequency(); // Selects the best fit freq and voltage to save as much energy as possible.
 void find_next_deadline(); // At any given time, finds the next deadline.
 int find_next_decision_point(); // At any given time, finds the next decision point.
-void add_dynamic_energy(); // Adds the dynamic power consumed by the current job to the total.
\ No newline at end of file
+int check_deadline(int, int); // Checks whether a job finished by its deadline once the deadline is reached, and applies the overrun policy.
+void abort_job(int); // Removes a job that missed its deadline from the ready queue.
+void print_deadline_miss_statistics(); // Prints the deadline misses, aborted and skipped jobs of every task.
+int admit_arrived_jobs(); // Adds all the jobs that have arrived till the current time to the ready queue.
+void add_dynamic_energy(float); // Adds the dynamic power consumed by the latest execution of the current job to the total.
+int find_hysteresis_level(int, int, float, float); // Keeps the current level if the change to a lower level does not pay for itself.
+void find_frequency_split(float); // Splits the allocation window between the two levels around the required speed.
+void switch_frequency_split(); // Switches to the lower level of a split allocation window.
+void cancel_frequency_split(); // Removes the pending switch of a split allocation window.
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "freq_and_voltage.h"
+#include "segment_index.h"
+
+// Global variables required to index the executed segments.
+
+// Output files.
+extern _Thread_local FILE *statistics_file;
+
+// Tasks and frequency (and voltage) data.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local long end_of_execution_time;
+
+// Segments sorted by time, along with the busy time and dynamic energy of all the segments before every segment (prefix sums).
+_Thread_local Indexed_segment *segments;
+_Thread_local long num_segments;
+_Thread_local long segments_capacity;
+_Thread_local double *prefix_busy_time;
+_Thread_local double *prefix_energy;
+
+// Block summaries. Row k holds the time of every task (and at every level) in the segments before segment k * SEGMENT_INDEX_BLOCK.
+_Thread_local double *block_task_time;
+_Thread_local double *block_level_time;
+_Thread_local double *current_task_time; // Time of every task in all the segments so far (the next row).
+_Thread_local double *current_level_time;
+
+
+/*
+ * Pre-condition: The sorted task-set and the frequencies.
+ * Post-condition: An empty index (if SEGMENT_INDEX is set). A task-set of more than SEGMENT_INDEX_MAX_TASKS tasks is rejected, as their sorted task numbers do not fit a segment.
+ */
+void
+init_segment_index()
+{
+    num_segments = 0;
+    segments_capacity = 0;
+    segments = NULL;
+    prefix_busy_time = NULL;
+    prefix_energy = NULL;
+    if (!SEGMENT_INDEX)
+        return;
+
+    if (num_tasks > SEGMENT_INDEX_MAX_TASKS)
+    {
+        fprintf(stderr, "ERROR: The segment index can only hold task-sets of at most %d tasks (the task-set has %d). Please turn off SEGMENT_INDEX.\n", SEGMENT_INDEX_MAX_TASKS, num_tasks);
+        exit(0);
+    }
+
+    segments_capacity = SEGMENT_INDEX_BLOCK;
+    segments = (Indexed_segment *) malloc(sizeof(Indexed_segment) * segments_capacity);
+    prefix_busy_time = (double *) malloc(sizeof(double) * (segments_capacity + 1));
+    prefix_energy = (double *) malloc(sizeof(double) * (segments_capacity + 1));
+    prefix_busy_time[0] = 0;
+    prefix_energy[0] = 0;
+
+    block_task_time = (double *) calloc(num_tasks, sizeof(double));
+    block_level_time = (double *) calloc(num_freq_levels, sizeof(double));
+    current_task_time = (double *) calloc(num_tasks, sizeof(double));
+    current_level_time = (double *) calloc(num_freq_levels, sizeof(double));
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A segment that a job (of the given sorted task and instance) has just executed at the given level. Segments are added in the order of time.
+ * Post-condition: The segment is appended to the index in amortised O(1) (and a row of block summaries every SEGMENT_INDEX_BLOCK segments).
+ */
+void
+add_indexed_segment(int sorted_task_num, int instance_num, int level, float start_time, float end_time)
+{
+    if (!segments || end_time <= start_time)
+        return;
+
+    if (num_segments == segments_capacity)
+    {
+        segments_capacity *= 2;
+        segments = (Indexed_segment *) realloc(segments, sizeof(Indexed_segment) * segments_capacity);
+        prefix_busy_time = (double *) realloc(prefix_busy_time, sizeof(double) * (segments_capacity + 1));
+        prefix_energy = (double *) realloc(prefix_energy, sizeof(double) * (segments_capacity + 1));
+        if (!segments || !prefix_busy_time || !prefix_energy)
+        {
+            fprintf(stderr, "ERROR: Could not allocate memory for the segment index.\n");
+            exit(0);
+        }
+    }
+
+    Indexed_segment *segment = &segments[num_segments];
+    segment->start = start_time;
+    segment->end = end_time;
+    segment->instance_num = instance_num;
+    segment->sorted_task_num = sorted_task_num;
+    segment->level = level;
+
+    float time = end_time - start_time;
+    prefix_busy_time[num_segments + 1] = prefix_busy_time[num_segments] + time;
+    prefix_energy[num_segments + 1] = prefix_energy[num_segments] + freq_and_voltage[level].dynamic_power * time;
+    current_task_time[sorted_task_num] += time;
+    current_level_time[level] += time;
+    num_segments++;
+
+    if (num_segments % SEGMENT_INDEX_BLOCK == 0)
+    {
+        long num_rows = num_segments / SEGMENT_INDEX_BLOCK + 1;
+        block_task_time = (double *) realloc(block_task_time, sizeof(double) * num_rows * num_tasks);
+        block_level_time = (double *) realloc(block_level_time, sizeof(double) * num_rows * num_freq_levels);
+        memcpy(&block_task_time[(num_rows - 1) * num_tasks], current_task_time, sizeof(double) * num_tasks);
+        memcpy(&block_level_time[(num_rows - 1) * num_freq_levels], current_level_time, sizeof(double) * num_freq_levels);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A time.
+ * Post-condition: Returns the first segment that ends after the time (num_segments if there is none), by binary search.
+ */
+int
+find_first_segment(float time)
+{
+    long low = 0, high = num_segments;
+    while (low < high)
+    {
+        long mid = (low + high) / 2;
+        if (segments[mid].end > time)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    return low;
+}
+
+
+/*
+ * Pre-condition: A time.
+ * Post-condition: Returns the last segment that starts before the time (-1 if there is none), by binary search.
+ */
+int
+find_last_segment(float time)
+{
+    long low = 0, high = num_segments;
+    while (low < high)
+    {
+        long mid = (low + high) / 2;
+        if (segments[mid].start < time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low - 1;
+}
+
+
+/*
+ * Pre-condition: A window of the schedule.
+ * Post-condition: Returns the time spent executing jobs within the window in O(log(number of segments)).
+ */
+double
+find_busy_time(float start_time, float end_time)
+{
+    int first = find_first_segment(start_time);
+    int last = find_last_segment(end_time);
+    if (first > last)
+        return 0;
+
+    // The segments at the ends of the window are clipped to it.
+    double time = prefix_busy_time[last + 1] - prefix_busy_time[first];
+    if (segments[first].start < start_time)
+        time -= start_time - segments[first].start;
+    if (segments[last].end > end_time)
+        time -= segments[last].end - end_time;
+
+    return time;
+}
+
+
+/*
+ * Pre-condition: A window of the schedule.
+ * Post-condition: Returns the dynamic energy of the jobs within the window in O(log(number of segments)).
+ */
+double
+find_window_energy(float start_time, float end_time)
+{
+    int first = find_first_segment(start_time);
+    int last = find_last_segment(end_time);
+    if (first > last)
+        return 0;
+
+    double energy = prefix_energy[last + 1] - prefix_energy[first];
+    if (segments[first].start < start_time)
+        energy -= freq_and_voltage[segments[first].level].dynamic_power * (start_time - segments[first].start);
+    if (segments[last].end > end_time)
+        energy -= freq_and_voltage[segments[last].level].dynamic_power * (segments[last].end - end_time);
+
+    return energy;
+}
+
+
+/*
+ * Pre-condition: A segment number, and arrays for the time of every task and at every level.
+ * Post-condition: The arrays hold the time of every task and at every level in the segments before the given one (from the row of its block and at most SEGMENT_INDEX_BLOCK segments).
+ */
+static void
+find_prefix_residency(long segment_num, double *task_time, double *level_time)
+{
+    long block = segment_num / SEGMENT_INDEX_BLOCK;
+    memcpy(task_time, &block_task_time[block * num_tasks], sizeof(double) * num_tasks);
+    memcpy(level_time, &block_level_time[block * num_freq_levels], sizeof(double) * num_freq_levels);
+
+    for (long i = block * SEGMENT_INDEX_BLOCK; i < segment_num; i++)
+    {
+        task_time[segments[i].sorted_task_num] += segments[i].end - segments[i].start;
+        level_time[segments[i].level] += segments[i].end - segments[i].start;
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A window of the schedule, and arrays for the time of every task (sorted) and at every frequency level.
+ * Post-condition: The arrays hold the time of every task and at every level within the window, in O(log(number of segments) + SEGMENT_INDEX_BLOCK).
+ */
+void
+find_window_residency(float start_time, float end_time, double *task_time, double *level_time)
+{
+    memset(task_time, 0, sizeof(double) * num_tasks);
+    memset(level_time, 0, sizeof(double) * num_freq_levels);
+
+    int first = find_first_segment(start_time);
+    int last = find_last_segment(end_time);
+    if (first > last)
+        return;
+
+    double *first_task_time = (double *) malloc(sizeof(double) * num_tasks);
+    double *first_level_time = (double *) malloc(sizeof(double) * num_freq_levels);
+    find_prefix_residency(first, first_task_time, first_level_time);
+    find_prefix_residency(last + 1, task_time, level_time);
+
+    for (int i = 0; i < num_tasks; i++)
+        task_time[i] -= first_task_time[i];
+    for (int i = 0; i < num_freq_levels; i++)
+        level_time[i] -= first_level_time[i];
+
+    // The segments at the ends of the window are clipped to it.
+    if (segments[first].start < start_time)
+    {
+        task_time[segments[first].sorted_task_num] -= start_time - segments[first].start;
+        level_time[segments[first].level] -= start_time - segments[first].start;
+    }
+    if (segments[last].end > end_time)
+    {
+        task_time[segments[last].sorted_task_num] -= segments[last].end - end_time;
+        level_time[segments[last].level] -= segments[last].end - end_time;
+    }
+
+    free(first_task_time);
+    free(first_level_time);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A file and a window of the schedule.
+ * Post-condition: Prints the segments that ran within the window (clipped to it).
+ */
+void
+print_window_segments(FILE *file, float start_time, float end_time)
+{
+    int last = find_last_segment(end_time);
+
+    fprintf(file, "Segments from t=%0.2f to t=%0.2f: ", start_time, end_time);
+    for (int i = find_first_segment(start_time); i <= last; i++)
+    {
+        Indexed_segment segment = segments[i];
+        fprintf(file, "J%d,%d (%0.2f to %0.2f at %0.2f), ", tasks[segment.sorted_task_num].task_num, segment.instance_num, (segment.start > start_time) ? segment.start : start_time, (segment.end < end_time) ? segment.end : end_time, freq_and_voltage[segment.level].freq);
+    }
+    fprintf(file, "\n");
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The index after the scheduler has finished.
+ * Post-condition: Prints the busy time, dynamic energy and residency of every window of SEGMENT_INDEX_WINDOW units of time (and the segments of the query window) onto the statistics file.
+ */
+void
+print_segment_index_statistics()
+{
+    if (!segments)
+        return;
+
+    double *task_time = (double *) malloc(sizeof(double) * num_tasks);
+    double *level_time = (double *) malloc(sizeof(double) * num_freq_levels);
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Segment index: %ld segments in %ld blocks of %d.\n", num_segments, num_segments / SEGMENT_INDEX_BLOCK + 1, SEGMENT_INDEX_BLOCK);
+    if (SEGMENT_INDEX_QUERY_END > SEGMENT_INDEX_QUERY_START)
+        print_window_segments(statistics_file, SEGMENT_INDEX_QUERY_START, SEGMENT_INDEX_QUERY_END);
+
+    for (long start = 0; start < end_of_execution_time; start += SEGMENT_INDEX_WINDOW)
+    {
+        long end = (start + SEGMENT_INDEX_WINDOW < end_of_execution_time) ? start + SEGMENT_INDEX_WINDOW : end_of_execution_time;
+        double busy_time = find_busy_time(start, end);
+        find_window_residency(start, end, task_time, level_time);
+
+        fprintf(statistics_file, "t=%ld to t=%ld: Busy: %0.2f (%0.1f%%), Dynamic energy: %0.2f, Utilisation per task: ", start, end, busy_time, busy_time / (end - start) * 100, find_window_energy(start, end));
+        for (int i = 0; i < num_tasks; i++)
+            fprintf(statistics_file, "Task-%d: %0.2f, ", tasks[i].task_num, task_time[i] / (end - start));
+        fprintf(statistics_file, "Time per frequency: ");
+        for (int i = 0; i < num_freq_levels; i++)
+            fprintf(statistics_file, "%0.2f: %0.2f, ", freq_and_voltage[i].freq, level_time[i]);
+        fprintf(statistics_file, "\n");
+    }
+
+    free(task_time);
+    free(level_time);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The index.
+ * Post-condition: Frees the segments, the prefix sums and the block summaries.
+ */
+void
+delete_segment_index()
+{
+    free(segments);
+    free(prefix_busy_time);
+    free(prefix_energy);
+    segments = NULL;
+    prefix_busy_time = NULL;
+    prefix_energy = NULL;
+
+    if (!SEGMENT_INDEX)
+        return;
+
+    free(block_task_time);
+    free(block_level_time);
+    free(current_task_time);
+    free(current_level_time);
+
+    return;
+}
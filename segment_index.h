@@ -0,0 +1,24 @@
+#define SEGMENT_INDEX_MAX_TASKS (1 << 24) // Limit of the task field of a segment.
+
+// Executed segment of a job (16 bytes). Segments are appended in the order they run, so they are sorted by time and never overlap.
+typedef struct
+{
+    float start;
+    float end;
+    int instance_num;
+    unsigned int sorted_task_num : 24; // Up to SEGMENT_INDEX_MAX_TASKS tasks.
+    unsigned int level : 8; // Frequency level of the segment.
+}
+Indexed_segment;
+
+// Functions.
+void init_segment_index(); // Starts an empty index (if SEGMENT_INDEX is set).
+void add_indexed_segment(int, int, int, float, float); // Appends an executed segment to the index.
+int find_first_segment(float); // The first segment that ends after the given time.
+int find_last_segment(float); // The last segment that starts before the given time.
+double find_busy_time(float, float); // Time spent executing jobs within a window.
+double find_window_energy(float, float); // Dynamic energy of the jobs within a window.
+void find_window_residency(float, float, double *, double *); // Time of every task and at every frequency level within a window.
+void print_window_segments(FILE *, float, float); // Prints the segments that ran within a window.
+void print_segment_index_statistics(); // Prints the occupancy, energy and residency of every window of SEGMENT_INDEX_WINDOW.
+void delete_segment_index(); // Frees the index.
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "aperiodic.h"
+#include "slack_reclaiming.h"
+
+// Global variables required to reclaim the slack of the jobs that finish early.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+
+// Scheduler.
+extern _Thread_local Job *ready_queue;
+extern _Thread_local int num_job_in_ready_queue;
+extern _Thread_local float current_time;
+
+// Slack pool, sorted based on the priority and then the deadline of the jobs that left the slack.
+_Thread_local Slack_entry *slack_pool;
+_Thread_local int num_slack_entries;
+
+// The job that holds reclaimed slack (-1 if none), and how much of it. The slack is held till another job runs or the job finishes.
+_Thread_local int slack_holder_job;
+_Thread_local float held_slack;
+
+// Statistics.
+_Thread_local float total_slack_donated;
+_Thread_local float total_slack_reclaimed;
+_Thread_local long num_slack_reclaims;
+
+
+/*
+ * Pre-condition: None.
+ * Post-condition: An empty slack pool.
+ */
+void
+init_slack_reclaiming()
+{
+    slack_pool = (Slack_entry *) malloc(sizeof(Slack_entry));
+    num_slack_entries = 0;
+    slack_holder_job = -1;
+    held_slack = 0;
+    total_slack_donated = 0;
+    total_slack_reclaimed = 0;
+    num_slack_reclaims = 0;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A periodic job that has just finished.
+ * Post-condition: The time it was budgeted for but did not use (its wcet minus its actual execution time) is added to the slack pool under its priority and deadline.
+ */
+void
+donate_slack(const Job *job)
+{
+    if (job->job_index == slack_holder_job) // The slack it held is used up along with the job.
+    {
+        slack_holder_job = -1;
+        held_slack = 0;
+    }
+
+    float slack = job->wcet - job->aet;
+    if (slack <= 0 || job->absolute_deadline <= current_time)
+        return;
+
+    total_slack_donated += slack;
+
+    // Finding the place of the entry (the jobs of a task finish in order, so an entry with the same key is the last one of its task).
+    int i = num_slack_entries;
+    while (i > 0 && (slack_pool[i - 1].sorted_task_num > job->sorted_task_num || (slack_pool[i - 1].sorted_task_num == job->sorted_task_num && slack_pool[i - 1].absolute_deadline > job->absolute_deadline)))
+        i--;
+
+    if (i > 0 && slack_pool[i - 1].sorted_task_num == job->sorted_task_num && slack_pool[i - 1].absolute_deadline == job->absolute_deadline)
+    {
+        slack_pool[i - 1].slack += slack;
+        return;
+    }
+
+    num_slack_entries++;
+    slack_pool = (Slack_entry *) realloc(slack_pool, sizeof(Slack_entry) * num_slack_entries);
+    for (int j = num_slack_entries - 1; j > i; j--)
+        slack_pool[j] = slack_pool[j - 1];
+    slack_pool[i].sorted_task_num = job->sorted_task_num;
+    slack_pool[i].absolute_deadline = job->absolute_deadline;
+    slack_pool[i].slack = slack;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The slack pool.
+ * Post-condition: The slack whose deadline has passed is dropped (it was only reserved for the schedule till that deadline).
+ */
+void
+expire_slack()
+{
+    int num_left = 0;
+    for (int i = 0; i < num_slack_entries; i++)
+    {
+        if (slack_pool[i].absolute_deadline > current_time && slack_pool[i].slack > 0)
+            slack_pool[num_left++] = slack_pool[i];
+    }
+    num_slack_entries = num_left;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A job that is about to run and the most slack it can use.
+ * Post-condition: Takes slack out of the pool and returns its amount. Only the slack of jobs of the same or higher priority is eligible, and it is taken
+ * from the highest priority (and then the earliest deadline) first, as that slack expires the soonest.
+ */
+float
+take_slack(const Job *job, float limit)
+{
+    expire_slack();
+
+    float taken = 0;
+    for (int i = 0; i < num_slack_entries && slack_pool[i].sorted_task_num <= job->sorted_task_num && taken < limit; i++)
+    {
+        float amount = (slack_pool[i].slack < limit - taken) ? slack_pool[i].slack : limit - taken;
+        slack_pool[i].slack -= amount;
+        taken += amount;
+    }
+    expire_slack(); // Drops the entries that were used up.
+
+    return taken;
+}
+
+
+/*
+ * Pre-condition: The dynamic utilisation found by CC-RM for the window till the next deadline and the length of the window. The ready queue with the job that runs next at its head.
+ * Post-condition: Returns the utilisation with the allotment of the job that runs next stretched by the slack it reclaims (the frequency is lowered right away instead of at a later allocation).
+ *
+ * The slack stretches the allotment only as far as the window still fits all the allotted work, and stays with the job till another job runs or the job finishes.
+ */
+float
+find_reclaimed_utilisation(float utilisation, float time_left)
+{
+    if (num_job_in_ready_queue == 0 || is_server_task(ready_queue[0].task_num))
+        return utilisation;
+
+    Job *job = &ready_queue[0];
+    float allotment = job->time_next_execution;
+    float room = time_left - utilisation * time_left;
+    if (job->job_index != slack_holder_job) // The slack of a preempted job is not handed on.
+    {
+        slack_holder_job = job->job_index;
+        held_slack = 0;
+    }
+    if (allotment <= 0 || room <= 0)
+        return utilisation;
+
+    if (held_slack < room)
+    {
+        float reclaimed = take_slack(job, room - held_slack);
+        if (reclaimed > 0)
+        {
+            held_slack += reclaimed;
+            total_slack_reclaimed += reclaimed;
+            num_slack_reclaims++;
+            fprintf(output_file, "Job J%d,%d reclaims %0.2f units of slack (holding %0.2f).\n", job->task_num, job->instance_num, reclaimed, held_slack);
+        }
+    }
+
+    float slack = (held_slack < room) ? held_slack : room;
+
+    return utilisation * allotment / (allotment + slack);
+}
+
+
+/*
+ * Pre-condition: The slack pool after the scheduler has finished.
+ * Post-condition: Prints how much slack was donated and reclaimed onto the statistics file.
+ */
+void
+print_slack_reclaiming_statistics()
+{
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "Slack reclaiming: Slack donated: %0.2f, Slack reclaimed: %0.2f (%ld times), Slack left unused: %0.1f%%\n", total_slack_donated, total_slack_reclaimed, num_slack_reclaims, (total_slack_donated > 0) ? (1 - total_slack_reclaimed / total_slack_donated) * 100 : 0);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The slack pool.
+ * Post-condition: Frees the slack pool.
+ */
+void
+delete_slack_reclaiming()
+{
+    free(slack_pool);
+
+    return;
+}
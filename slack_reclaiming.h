@@ -0,0 +1,17 @@
+// Unused time of the finished jobs of a task (whose deadline has not passed), that the jobs of the same or lower priority can reclaim.
+typedef struct
+{
+    int sorted_task_num; // Priority of the job that left the slack.
+    long absolute_deadline; // The slack cannot be used after this deadline.
+    float slack;
+}
+Slack_entry;
+
+// Functions.
+void init_slack_reclaiming(); // Empties the slack pool.
+void donate_slack(const Job *); // Adds the unused time of a job that finished early to the slack pool.
+void expire_slack(); // Drops the slack whose deadline has passed.
+float take_slack(const Job *, float); // Takes at most the given amount of slack that a job is eligible for out of the pool.
+float find_reclaimed_utilisation(float, float); // Lowers the dynamic utilisation with the slack that the job that runs next reclaims.
+void print_slack_reclaiming_statistics(); // Prints how much slack was donated and reclaimed.
+void delete_slack_reclaiming(); // Frees the slack pool.
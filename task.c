@@ -1,24 +1,28 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <float.h>
+#include <math.h>
 
 #include "configuration.h"
 #include "utility.h"
 #include "task.h"
 #include "job.h"
 #include "freq_and_voltage.h"
+#include "parser.h"
+#include "aperiodic.h"
+#include "overhead.h"
 
-extern FILE *input_tasks_file;
-extern FILE *output_file;
-extern FILE *statistics_file;
+extern Input_file input_tasks_file;
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
 
-extern int num_tasks;
-extern Task *tasks;
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
 
-extern int num_jobs;
-extern Job *jobs;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
 
-extern Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
 
 
 /*
@@ -55,9 +59,13 @@ create_input_sort_print_tasks()
 void
 create_tasks()
 {
-    fscanf(input_tasks_file, "%d", &num_tasks);
+    long num_tasks_input;
+    if (!scan_long(&input_tasks_file, &num_tasks_input) || num_tasks_input <= 0)
+        parse_error(&input_tasks_file, input_tasks_file.line, "Invalid number of tasks");
+    num_tasks = num_tasks_input;
 
-    tasks = (Task *) malloc(sizeof(Task) * num_tasks);
+    // Zeroed, so that the statistics arrays are NULL till they are allocated. (One extra task for the aperiodic server, if there is one).
+    tasks = (Task *) calloc(num_tasks + server_enabled(), sizeof(Task));
 
     return;
 }
@@ -75,16 +83,26 @@ input_tasks()
     for (int i = 0; i < num_tasks; i++) // Iterates over all tasks.
     {
         tasks[i].task_num = i;
-        fscanf(input_tasks_file, "%ld %ld %f %ld", &tasks[i].phase, &tasks[i].period, &tasks[i].wcet, &tasks[i].deadline);
+
+        // Every task is on its own line.
+        skip_whitespace(&input_tasks_file);
+        int line = input_tasks_file.line;
+
+        if (!scan_long(&input_tasks_file, &tasks[i].phase) || !scan_long(&input_tasks_file, &tasks[i].period) || !scan_float(&input_tasks_file, &tasks[i].wcet) || !scan_long(&input_tasks_file, &tasks[i].deadline))
+            parse_error(&input_tasks_file, line, "Expected the phase, period, wcet and deadline of a task");
+
+        if (input_tasks_file.line != line || !end_of_line(&input_tasks_file))
+            parse_error(&input_tasks_file, line, "A task has to be given as exactly four values on one line");
 
         // Checks if the data inputted is valid or not.
-        if ((tasks[i].period < tasks[i].wcet) || (tasks[i].phase < 0 || tasks[i].period < 0 || tasks[i].wcet < 0 || tasks[i].deadline < 0))
-        {
-            fprintf(stderr, "ERROR: Invalid task input. Please input valid data.\n");
-            exit(0);
-        }
+        if ((tasks[i].period < tasks[i].wcet) || (tasks[i].phase < 0 || tasks[i].period <= 0 || tasks[i].wcet < 0 || tasks[i].deadline < 0))
+            parse_error(&input_tasks_file, line, "Invalid task input");
     }
 
+    // The server of the aperiodic and sporadic jobs is scheduled as a periodic task.
+    if (server_enabled())
+        add_server_task();
+
     // Finding the number of instances for every task.
     calculate_num_instances_of_tasks();
 
@@ -143,6 +161,29 @@ sort_tasks_comparator(const void *a, const void *b)
 }
 
 
+/*
+ * Pre-condition: Two different tasks.
+ * Post-condition: Integer representing the answer of the comparision.
+ * 
+ * Compares the two tasks based on utilisation (in decreasing order). Used by the partitioning heuristics.
+ */
+int
+sort_tasks_utilisation_comparator(const void *a, const void *b)
+{
+    Task task_a, task_b;
+    task_a = *((Task *) a);
+    task_b = *((Task *) b);
+
+    float utilisation_a = task_a.wcet / task_a.period;
+    float utilisation_b = task_b.wcet / task_b.period;
+
+    if (utilisation_a != utilisation_b)
+        return (utilisation_a < utilisation_b) ? 1 : -1;
+    else
+        return sort_tasks_comparator(a, b); // Else compare in the same way as RM.
+}
+
+
 /*
  * Pre-condition: sorted or unsorted tasks data.
  * Post-condition: Task data in a sorted manner.
@@ -366,15 +407,15 @@ print_execution_freqs()
         fprintf(statistics_file, "Task-%d: ", task.task_num);
         for (int j = 0; j < task.num_instances; j++) // Iterates through each task instance of the given task.
         {
-            execution_freq = freq_and_voltage[task.execution_freq_indices[j]].freq;
-            execution_voltage = freq_and_voltage[task.execution_freq_indices[j]].voltage;
-
-            if (task.execution_times[j] <= 0)
+            if (task.execution_times[j] <= 0) // Jobs that did not execute have no frequency of execution.
             {
                 fprintf(statistics_file, "ND (ND), ");
                 continue;
             }
 
+            execution_freq = freq_and_voltage[task.execution_freq_indices[j]].freq;
+            execution_voltage = freq_and_voltage[task.execution_freq_indices[j]].voltage;
+
             fprintf(statistics_file, "%0.2f (%0.2fV), ", execution_freq, execution_voltage);
 
             avg_freq += execution_freq;
@@ -526,4 +567,176 @@ delete_tasks()
     free(tasks);
     
     return;
-}
\ No newline at end of file
+}
+
+
+/*
+ * Pre-condition: A task-set sorted based on period, the number of tasks in it and the relative frequency at some level that is to be tested.
+ * Post-condition: Returns a value indicating the result of the test (1 = pass and 0 = fail).
+ */
+int
+rm_test_task_set(const Task *task_set, int num_tasks_in_set, float relative_freq)
+{
+    /*
+     * For all tasks Ti and Periods sorted in ascending order,
+     *      if (floor(Pi/P1) * C1) + (floor(Pi/P2) * C2) + ......... + (floor(Pi/Pi) * Ci) <= relative_freq * Pi
+     *      then return 1
+     *      else 0
+     * With SCHEDULABILITY_WITH_OVERHEADS, every Ck also includes the overheads of its job (which take the same time at every frequency).
+     */
+    float job_overheads = SCHEDULABILITY_WITH_OVERHEADS ? find_job_overheads(num_tasks_in_set) : 0;
+
+    for (int i = 0; i < num_tasks_in_set; i++) // Iterating through all tasks.
+    {
+        float sum = 0;
+        for (int k = 0; k <= i; k++) // Iterating till the ith period.
+        {
+            int int_divide = task_set[i].period / task_set[k].period;
+            sum += int_divide * (task_set[k].wcet + job_overheads * relative_freq);
+        }
+
+        if (sum > task_set[i].period * relative_freq)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: A task-set sorted based on period (priority), the number of tasks in it and the relative frequency at some level that is to be tested.
+ * Post-condition: Returns 1 if the worst-case response time of every task is within its deadline (exact response-time analysis for RM), 0 otherwise.
+ */
+int
+response_time_test(const Task *task_set, int num_tasks_in_set, float relative_freq)
+{
+    // With SCHEDULABILITY_WITH_OVERHEADS, every Ck / f also includes the overheads of its job.
+    float job_overheads = SCHEDULABILITY_WITH_OVERHEADS ? find_job_overheads(num_tasks_in_set) : 0;
+
+    return find_response_times(task_set, num_tasks_in_set, relative_freq, job_overheads, NULL);
+}
+
+
+/*
+ * Pre-condition: A task-set sorted based on period (priority), the number of tasks in it, the relative frequency at some level, the overheads that every job is charged with
+ * and an array to hold the response time of every task (or NULL).
+ * Post-condition: Returns 1 if the worst-case response time of every task is within its deadline, 0 otherwise. The response times are stored in the array
+ * (the analysis of a task stops once its response time is past its deadline, and the tasks after the first one that misses are not analysed).
+ */
+int
+find_response_times(const Task *task_set, int num_tasks_in_set, float relative_freq, float job_overheads, float *response_times)
+{
+    /*
+     * For every task Ti, the response time is the smallest fixed point of
+     *      Ri = Ci / f + O + sum over higher priority tasks Tk of (ceil(Ri / Pk) * (Ck / f + O))
+     * where O is the overheads of a job (which take the same time at every frequency), and the task is schedulable if Ri <= Di.
+     */
+    for (int i = 0; i < num_tasks_in_set; i++) // Iterating through all tasks.
+    {
+        double response_time = task_set[i].wcet / relative_freq + job_overheads;
+        double prev_response_time = 0;
+
+        while (response_time != prev_response_time && response_time <= task_set[i].deadline)
+        {
+            prev_response_time = response_time;
+            response_time = task_set[i].wcet / relative_freq + job_overheads;
+            for (int k = 0; k < i; k++) // Iterating through the higher priority tasks.
+            {
+                response_time += ceil(prev_response_time / task_set[k].period) * (task_set[k].wcet / relative_freq + job_overheads);
+            }
+        }
+
+        if (response_times)
+            response_times[i] = response_time;
+
+        if (response_time > task_set[i].deadline)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * Pre-condition: A task-set sorted based on period (priority), the preemption threshold of every task (as an index into the task-set, at most its own index), the number of tasks in it and the relative frequency at some level that is to be tested.
+ * Post-condition: Returns 1 if the worst-case response time of every task is within its deadline under preemption-threshold scheduling, 0 otherwise.
+ */
+int
+preemption_threshold_test(const Task *task_set, const int *thresholds, int num_tasks_in_set, float relative_freq)
+{
+    /*
+     * A started job of Ti can only be preempted by the tasks Tk with k < threshold(i). So Ti is blocked by at most one lower priority job whose threshold is at least its priority,
+     *      Bi = max over tasks Tj with j > i and threshold(j) <= i of Cj / f.
+     * Every job q of Ti in the level-i busy period starts at the smallest fixed point of
+     *      Siq = Bi + q * Ci / f + sum over tasks Tk with k < i of ((1 + floor(Siq / Pk)) * Ck / f)
+     * and then finishes at the smallest fixed point of
+     *      Fiq = Siq + Ci / f + sum over tasks Tk with k < threshold(i) of ((ceil(Fiq / Pk) - 1 - floor(Siq / Pk)) * Ck / f)
+     * and the task is schedulable if Fiq - q * Pi <= Di for every job q.
+     * With SCHEDULABILITY_WITH_OVERHEADS, every Ck / f also includes the overheads of its job.
+     */
+    float job_overheads = SCHEDULABILITY_WITH_OVERHEADS ? find_job_overheads(num_tasks_in_set) : 0;
+
+    for (int i = 0; i < num_tasks_in_set; i++) // Iterating through all tasks.
+    {
+        double cost = task_set[i].wcet / relative_freq + job_overheads;
+
+        // The busy period is unbounded if the tasks of priority >= Ti need more than the whole core.
+        double utilisation = 0;
+        for (int k = 0; k <= i; k++)
+            utilisation += (task_set[k].wcet / relative_freq + job_overheads) / task_set[k].period;
+        if (utilisation > 1)
+            return 0;
+
+        double blocking = 0;
+        for (int j = i + 1; j < num_tasks_in_set; j++)
+        {
+            if (thresholds[j] <= i && task_set[j].wcet / relative_freq + job_overheads > blocking)
+                blocking = task_set[j].wcet / relative_freq + job_overheads;
+        }
+
+        // Length of the level-i busy period.
+        double busy_period = blocking + cost;
+        double prev_busy_period = 0;
+        while (busy_period != prev_busy_period)
+        {
+            prev_busy_period = busy_period;
+            busy_period = blocking;
+            for (int k = 0; k <= i; k++)
+                busy_period += ceil(prev_busy_period / task_set[k].period) * (task_set[k].wcet / relative_freq + job_overheads);
+        }
+
+        int num_jobs_in_busy_period = (int) ceil(busy_period / task_set[i].period);
+        for (int q = 0; q < num_jobs_in_busy_period; q++)
+        {
+            double start_time = blocking + q * cost;
+            double prev_start_time = -1;
+            while (start_time != prev_start_time)
+            {
+                prev_start_time = start_time;
+                start_time = blocking + q * cost;
+                for (int k = 0; k < i; k++)
+                    start_time += (1 + floor(prev_start_time / task_set[k].period)) * (task_set[k].wcet / relative_freq + job_overheads);
+            }
+
+            double finish_time = start_time + cost;
+            double prev_finish_time = -1;
+            while (finish_time != prev_finish_time && finish_time - q * task_set[i].period <= task_set[i].deadline)
+            {
+                prev_finish_time = finish_time;
+                finish_time = start_time + cost;
+                for (int k = 0; k < thresholds[i]; k++)
+                    finish_time += (ceil(prev_finish_time / task_set[k].period) - 1 - floor(start_time / task_set[k].period)) * (task_set[k].wcet / relative_freq + job_overheads);
+            }
+
+            if (finish_time - q * task_set[i].period > task_set[i].deadline)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
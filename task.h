@@ -24,6 +24,7 @@ void create_tasks(); // Allocates memory for task array.
 void input_tasks(); // Takes input and initialises the task array.
 void print_tasks(); // Prints the task-set info.
 int sort_tasks_comparator(const void *, const void *); // Comparator used to sort the task-set.
+int sort_tasks_utilisation_comparator(const void *, const void *); // Comparator used to sort the task-set based on decreasing utilisation.
 void sort_tasks(); // Sorts task array based on period (and priority in the case of RM).
 long find_max_phase(); // Finds the largest phase of the task-set (to help with finding the end time of execution).
 void delete_tasks(); // Deallocates and frees the data used by the task array when no longer needed.
@@ -35,4 +36,10 @@ void print_response_time_jitters(); // Finds and prints the response time jitter
 void print_execution_times(); // Finds and prints the execution times of all the jobs in the task-set.
 void print_waiting_times(); // Finds and prints the waiting times of all the jobs in the task-set.
 void print_execution_freqs(); // Finds and prints the execution frequencies and voltages of all jobs in the task set.
-void print_dynamic_energy_consumed(); // Finds and prints the dynamic energy consumed by all the jobs in the task set.
\ No newline at end of file
+void print_dynamic_energy_consumed(); // Finds and prints the dynamic energy consumed by all the jobs in the task set.
+
+// Functions related to the schedulability analysis of a task-set.
+int rm_test_task_set(const Task *, int, float); // Same as rm_test(), but for any task-set sorted based on period (such as the tasks of one core).
+int response_time_test(const Task *, int, float); // Exact response-time analysis of a task-set sorted based on priority at a given frequency.
+int find_response_times(const Task *, int, float, float, float *); // Worst-case response time of every task of a task-set sorted based on priority, with the given overheads charged to every job.
+int preemption_threshold_test(const Task *, const int *, int, float); // Response-time analysis of a task-set sorted based on priority under preemption-threshold scheduling at a given frequency.
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "configuration.h"
+#include "taskset_cache.h"
+#include "utility.h"
+#include "task.h"
+#include "freq_and_voltage.h"
+#include "parser.h"
+#include "overhead.h"
+
+#define TASKSET_CACHE_MAGIC "CCRMTS2"
+
+extern Input_file input_tasks_file;
+extern Input_file input_freq_file;
+extern _Thread_local FILE *output_file;
+
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+
+extern _Thread_local int num_freq_levels;
+extern _Thread_local Freq_and_voltage *freq_and_voltage;
+extern _Thread_local Level_transition *level_transitions;
+extern _Thread_local Freq_and_voltage static_freq_and_voltage;
+extern _Thread_local int static_freq_and_voltage_index;
+
+extern int num_overhead_entries;
+extern Overhead_entry *overhead_table;
+
+extern _Thread_local long hyperperiod;
+extern _Thread_local long first_in_phase_time;
+extern _Thread_local long end_of_execution_time;
+
+_Thread_local float cached_task_utilisation; // Worst-case task utilisation (only known without re-calculation when the cache is used).
+
+
+/*
+ * Pre-condition: The current hash value and a block of bytes.
+ * Post-condition: The FNV-1a hash of the block continued from the given hash value.
+ */
+static unsigned long long
+hash_bytes(unsigned long long hash, const char *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char) data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+
+/*
+ * Pre-condition: The memory-mapped input files.
+ * Post-condition: A hash of the contents of the input files and of the configuration that the precomputed metadata depends on.
+ */
+unsigned long long
+find_inputs_hash()
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    char configuration[256];
+
+    hash = hash_bytes(hash, TASKSET_CACHE_MAGIC, sizeof(TASKSET_CACHE_MAGIC));
+    hash = hash_bytes(hash, input_tasks_file.data, input_tasks_file.size);
+    hash = hash_bytes(hash, input_freq_file.data, input_freq_file.size);
+
+    // The static frequency depends on the overheads (and the task-set on the aperiodic server) as well.
+    int length = snprintf(configuration, sizeof(configuration), "%f %f %f %f %d %d %f %d", PREEMPTION_OVERHEAD, DECISION_MAKING_OVERHEAD, FREQUENCY_CALCULATION_OVERHEAD, FREQUENCY_CHANGE_OVERHEAD, APERIODIC_SERVER, SERVER_PERIOD, SERVER_BUDGET, NUM_CORES);
+    hash = hash_bytes(hash, configuration, length);
+
+    // As does the overhead model when the schedulability tests include the overheads.
+    if (SCHEDULABILITY_WITH_OVERHEADS || OVERHEAD_AWARE_STATIC_FREQUENCY)
+    {
+        length = snprintf(configuration, sizeof(configuration), "%d %f %f %f", OVERHEAD_MODEL, DECISION_MAKING_OVERHEAD_PER_JOB, FREQUENCY_CALCULATION_OVERHEAD_PER_JOB, FREQUENCY_CALCULATION_OVERHEAD_PER_LEVEL);
+        hash = hash_bytes(hash, configuration, length);
+        hash = hash_bytes(hash, (const char *) overhead_table, sizeof(Overhead_entry) * num_overhead_entries);
+        length = snprintf(configuration, sizeof(configuration), "%d %d", SCHEDULABILITY_WITH_OVERHEADS, OVERHEAD_AWARE_STATIC_FREQUENCY);
+        hash = hash_bytes(hash, configuration, length);
+    }
+
+    return hash;
+}
+
+
+/*
+ * Pre-condition: A buffer to hold the name of the file and its size.
+ * Post-condition: The name of the cache file for the current inputs.
+ */
+void
+find_taskset_cache_file_name(char *file_name, int size)
+{
+    snprintf(file_name, size, "%s%016llx.bin", TASKSET_CACHE_FILE_PREFIX, find_inputs_hash());
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The memory-mapped input files. Uninitialised task and frequency arrays.
+ * Post-condition: If a valid cache exists for the inputs, the sorted task-set, the sorted frequencies and the metadata of the task-set are initialised from it and 1 is returned. Otherwise 0 is returned and nothing is initialised.
+ */
+int
+load_taskset_cache()
+{
+    char file_name[256];
+    find_taskset_cache_file_name(file_name, sizeof(file_name));
+
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0) // No cache for these inputs yet.
+        return 0;
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0 || (size_t) file_stat.st_size < sizeof(Taskset_cache_header))
+    {
+        close(fd);
+        return 0;
+    }
+
+    // The whole cache is read with a single mapping.
+    size_t size = file_stat.st_size;
+    char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return 0;
+
+    Taskset_cache_header header;
+    memcpy(&header, data, sizeof(header));
+
+    // Checking that the cache belongs to these inputs and is not truncated.
+    size_t expected_size = sizeof(Taskset_cache_header) + header.num_tasks * sizeof(Cached_task) + header.num_freq_levels * sizeof(Freq_and_voltage) + header.num_freq_levels * header.num_freq_levels * sizeof(Level_transition);
+    if (memcmp(header.magic, TASKSET_CACHE_MAGIC, sizeof(TASKSET_CACHE_MAGIC)) != 0 || header.content_hash != find_inputs_hash() || header.num_tasks <= 0 || header.num_freq_levels <= 0 || size != expected_size)
+    {
+        munmap(data, size);
+        return 0;
+    }
+
+    // Task-set (already sorted).
+    num_tasks = header.num_tasks;
+    tasks = (Task *) calloc(num_tasks, sizeof(Task));
+    const Cached_task *cached_tasks = (const Cached_task *) (data + sizeof(Taskset_cache_header));
+    for (int i = 0; i < num_tasks; i++)
+    {
+        tasks[i].task_num = cached_tasks[i].task_num;
+        tasks[i].num_instances = cached_tasks[i].num_instances;
+        tasks[i].phase = cached_tasks[i].phase;
+        tasks[i].period = cached_tasks[i].period;
+        tasks[i].deadline = cached_tasks[i].deadline;
+        tasks[i].wcet = cached_tasks[i].wcet;
+    }
+
+    // Frequencies (already sorted).
+    num_freq_levels = header.num_freq_levels;
+    freq_and_voltage = (Freq_and_voltage *) malloc(sizeof(Freq_and_voltage) * num_freq_levels);
+    memcpy(freq_and_voltage, cached_tasks + num_tasks, sizeof(Freq_and_voltage) * num_freq_levels);
+
+    // Transition table of the levels.
+    level_transitions = (Level_transition *) malloc(sizeof(Level_transition) * num_freq_levels * num_freq_levels);
+    memcpy(level_transitions, (const Freq_and_voltage *) (cached_tasks + num_tasks) + num_freq_levels, sizeof(Level_transition) * num_freq_levels * num_freq_levels);
+
+    // Metadata.
+    hyperperiod = header.hyperperiod;
+    first_in_phase_time = header.first_in_phase_time;
+    end_of_execution_time = header.end_of_execution_time;
+    static_freq_and_voltage_index = header.static_freq_and_voltage_index;
+    static_freq_and_voltage = freq_and_voltage[static_freq_and_voltage_index];
+    cached_task_utilisation = header.task_utilisation;
+
+    munmap(data, size);
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: The sorted task-set, the sorted frequencies and the metadata of the task-set.
+ * Post-condition: Writes all of them to the cache file of the current inputs.
+ */
+void
+save_taskset_cache()
+{
+    char file_name[256];
+    find_taskset_cache_file_name(file_name, sizeof(file_name));
+
+    // Written to a temporary file first so that a partially written cache is never used.
+    char temp_file_name[300];
+    snprintf(temp_file_name, sizeof(temp_file_name), "%s.tmp", file_name);
+
+    FILE *cache_file = fopen(temp_file_name, "wb");
+    if (!cache_file)
+    {
+        fprintf(stderr, "WARNING: Could not create the task-set cache %s.\n", file_name);
+        return;
+    }
+
+    Taskset_cache_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TASKSET_CACHE_MAGIC, sizeof(TASKSET_CACHE_MAGIC));
+    header.content_hash = find_inputs_hash();
+    header.num_tasks = num_tasks;
+    header.num_freq_levels = num_freq_levels;
+    header.hyperperiod = hyperperiod;
+    header.first_in_phase_time = first_in_phase_time;
+    header.end_of_execution_time = end_of_execution_time;
+    header.static_freq_and_voltage_index = static_freq_and_voltage_index;
+    header.task_utilisation = calculate_task_utilisation();
+    fwrite(&header, sizeof(header), 1, cache_file);
+
+    for (int i = 0; i < num_tasks; i++) // Iterating through each task in the task-set.
+    {
+        Cached_task cached_task;
+        memset(&cached_task, 0, sizeof(cached_task));
+        cached_task.task_num = tasks[i].task_num;
+        cached_task.num_instances = tasks[i].num_instances;
+        cached_task.phase = tasks[i].phase;
+        cached_task.period = tasks[i].period;
+        cached_task.deadline = tasks[i].deadline;
+        cached_task.wcet = tasks[i].wcet;
+        fwrite(&cached_task, sizeof(cached_task), 1, cache_file);
+    }
+
+    fwrite(freq_and_voltage, sizeof(Freq_and_voltage), num_freq_levels, cache_file);
+    fwrite(level_transitions, sizeof(Level_transition), num_freq_levels * num_freq_levels, cache_file);
+
+    if (fclose(cache_file) != 0 || rename(temp_file_name, file_name) != 0)
+    {
+        fprintf(stderr, "WARNING: Could not create the task-set cache %s.\n", file_name);
+        remove(temp_file_name);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The metadata of the task-set loaded from the cache.
+ * Post-condition: Prints the metadata onto the output file (in the same way as when it is calculated).
+ */
+void
+print_taskset_metadata()
+{
+    char file_name[256];
+    find_taskset_cache_file_name(file_name, sizeof(file_name));
+
+    fprintf(output_file, "------------------------------------------------------------\n");
+    fprintf(output_file, "Task-set metadata loaded from %s.\n", file_name);
+    fprintf(output_file, "Task set has a utilisation: %0.2f.\n", cached_task_utilisation);
+    fprintf(output_file, "Hyperperiod: %ld\n", hyperperiod);
+    fprintf(output_file, "First in-phase time: %ld (will be = -1 if first in-phase time not <= 2 * hyperperiod).\n", first_in_phase_time);
+    fprintf(output_file, "End of execution time: %ld\n", end_of_execution_time);
+
+    // The task-set and frequencies are printed in the same way as when they are read from the text inputs.
+    print_tasks();
+    print_freq_and_voltage();
+    fprintf(output_file, "This task-set demands static freq: %0.2f, static voltage: %0.2f\n", static_freq_and_voltage.freq, static_freq_and_voltage.voltage);
+    if (OVERHEAD_AWARE_STATIC_FREQUENCY)
+        print_static_slack_margins();
+
+    return;
+}
@@ -0,0 +1,35 @@
+typedef struct
+{
+    char magic[8]; // Identifies the file as a task-set cache of this format version.
+    unsigned long long content_hash; // Hash of the input files and the configuration the metadata depends on.
+
+    int num_tasks;
+    int num_freq_levels;
+
+    // Precomputed metadata of the task-set.
+    long hyperperiod;
+    long first_in_phase_time;
+    long end_of_execution_time;
+    int static_freq_and_voltage_index;
+    float task_utilisation;
+}
+Taskset_cache_header;
+
+typedef struct
+{
+    // Same as the timing characteristics of Task (without the heap data used for statistics).
+    int task_num;
+    int num_instances;
+    long phase;
+    long period;
+    long deadline;
+    float wcet;
+}
+Cached_task;
+
+// Functions.
+unsigned long long find_inputs_hash(); // Hashes the contents of the input files along with the relevant configuration.
+void find_taskset_cache_file_name(char *, int); // Finds the name of the cache file corresponding to the current inputs.
+int load_taskset_cache(); // Loads the task-set, frequencies and metadata from the cache file (returns 1 on success and 0 otherwise).
+void save_taskset_cache(); // Saves the sorted task-set, frequencies and metadata to the cache file.
+void print_taskset_metadata(); // Prints the metadata that was loaded from the cache file.
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "trace.h"
+
+// Global variables required to export the schedule as a Chrome/Perfetto trace.
+
+// Tasks.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+
+// Trace file of the simulation running in this thread (NULL if it is not traced, as in the baseline simulation).
+_Thread_local FILE *trace_file;
+_Thread_local int trace_pid; // Process of the trace that the events belong to (the core).
+_Thread_local long num_trace_events;
+
+
+/*
+ * Pre-condition: The name of the trace file.
+ * Post-condition: The trace file is opened with a large buffer and the JSON array of the trace events is started.
+ *
+ * The events are written as they happen (one per line), so the trace is never held in memory, however long the schedule is.
+ */
+void
+open_trace(const char *file_name)
+{
+    trace_file = fopen(file_name, "w");
+    if (!trace_file)
+    {
+        fprintf(stderr, "ERROR: Could not open the trace file %s.\n", file_name);
+        exit(0);
+    }
+    setvbuf(trace_file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+    trace_pid = 0;
+    num_trace_events = 0;
+    fprintf(trace_file, "[\n");
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The sorted task-set of the core being simulated, its number and its name.
+ * Post-condition: The process of the core and the tracks of the overheads, the idle intervals and every task are named.
+ */
+void
+trace_metadata(int pid, const char *process_name)
+{
+    if (!trace_file)
+        return;
+
+    trace_pid = pid;
+    fprintf(trace_file, "%s{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"%s\"}}", num_trace_events++ ? ",\n" : "", trace_pid, process_name);
+    trace_thread_name(TRACE_OVERHEAD_TID, "Overheads");
+    trace_thread_name(TRACE_IDLE_TID, "Idle");
+
+    char name[64];
+    for (int i = 0; i < num_tasks; i++)
+    {
+        snprintf(name, sizeof(name), "Task-%d", tasks[i].task_num);
+        trace_thread_name(TRACE_TASK_TID(tasks[i].task_num), name);
+    }
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A track and its name.
+ * Post-condition: The track is shown with the name (and sorted by its number).
+ */
+void
+trace_thread_name(int tid, const char *name)
+{
+    if (!trace_file)
+        return;
+
+    fprintf(trace_file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"%s\"}}", num_trace_events++ ? ",\n" : "", trace_pid, tid, name);
+    fprintf(trace_file, ",\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"sort_index\": %d}}", trace_pid, tid, tid);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A track, the category and name of an interval, and its start and end (in units of time of the simulation).
+ * Post-condition: The interval is written as a complete event. Empty intervals are not written.
+ */
+void
+trace_slice(int tid, const char *category, const char *name, float start_time, float end_time)
+{
+    if (!trace_file || end_time <= start_time)
+        return;
+
+    fprintf(trace_file, "%s{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %0.3f, \"dur\": %0.3f}", num_trace_events++ ? ",\n" : "", name, category, trace_pid, tid, start_time * TRACE_TIME_SCALE, (end_time - start_time) * TRACE_TIME_SCALE);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The track of the task of a job (or of a core), the job, the segment it executed in and the frequency it executed at.
+ * Post-condition: The segment is written as a complete event named after the job.
+ */
+void
+trace_job_slice(int tid, const Job *job, float start_time, float end_time, float freq)
+{
+    if (!trace_file || end_time <= start_time)
+        return;
+
+    fprintf(trace_file, "%s{\"name\": \"J%d,%d\", \"cat\": \"job\", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %0.3f, \"dur\": %0.3f, \"args\": {\"freq\": %0.2f, \"deadline\": %ld}}", num_trace_events++ ? ",\n" : "", job->task_num, job->instance_num, trace_pid, tid, start_time * TRACE_TIME_SCALE, (end_time - start_time) * TRACE_TIME_SCALE, freq, job->absolute_deadline);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A track, the name of an event and its time.
+ * Post-condition: The event is written as an instant event on the track.
+ */
+void
+trace_instant(int tid, const char *name, float time)
+{
+    if (!trace_file)
+        return;
+
+    fprintf(trace_file, "%s{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": %d, \"tid\": %d, \"ts\": %0.3f}", num_trace_events++ ? ",\n" : "", name, trace_pid, tid, time * TRACE_TIME_SCALE);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The name of a counter, the time from which it has the given value, and the value.
+ * Post-condition: The value is written as a counter event (shown as a counter track of the process).
+ */
+void
+trace_counter(const char *name, float time, float value)
+{
+    if (!trace_file)
+        return;
+
+    fprintf(trace_file, "%s{\"name\": \"%s\", \"ph\": \"C\", \"pid\": %d, \"ts\": %0.3f, \"args\": {\"value\": %0.4f}}", num_trace_events++ ? ",\n" : "", name, trace_pid, time * TRACE_TIME_SCALE, value);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The time from which the core runs at the given frequency and voltage.
+ * Post-condition: The frequency and voltage counter tracks are updated.
+ */
+void
+trace_frequency(float time, float freq, float voltage)
+{
+    trace_counter("Frequency", time, freq);
+    trace_counter("Voltage", time, voltage);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: An open trace file.
+ * Post-condition: The array of trace events is ended and the file is closed.
+ */
+void
+close_trace()
+{
+    if (!trace_file)
+        return;
+
+    fprintf(trace_file, "\n]\n");
+    fclose(trace_file);
+    trace_file = NULL;
+
+    return;
+}
@@ -0,0 +1,15 @@
+// Tracks of the trace (thread ids within the process of a core). Every task has a track of its own after the overhead and idle tracks.
+#define TRACE_OVERHEAD_TID 0
+#define TRACE_IDLE_TID 1
+#define TRACE_TASK_TID(task_num) ((task_num) + 2)
+
+// Functions.
+void open_trace(const char *); // Opens the trace file and starts the array of trace events.
+void trace_metadata(int, const char *); // Names the process of the trace and the tracks of the tasks.
+void trace_thread_name(int, const char *); // Names a track.
+void trace_slice(int, const char *, const char *, float, float); // Writes an interval on a track.
+void trace_job_slice(int, const Job *, float, float, float); // Writes an executed segment of a job on its track (along with its frequency).
+void trace_instant(int, const char *, float); // Writes an instant event on a track.
+void trace_counter(const char *, float, float); // Writes the value of a counter track from the given time.
+void trace_frequency(float, float, float); // Writes the frequency and voltage counters from the given time.
+void close_trace(); // Ends the array of trace events and closes the trace file.
@@ -8,18 +8,28 @@
 #include "task.h"
 #include "freq_and_voltage.h"
 #include "job.h"
+#include "parser.h"
+#include "taskset_cache.h"
+#include "histogram.h"
+#include "trace.h"
+#include "schedule_log.h"
+#include "overhead.h"
 
-extern int num_tasks;
-extern Task *tasks;
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
 
-extern long hyperperiod;
-extern long first_in_phase_time;
-extern long end_of_execution_time;
+extern _Thread_local long hyperperiod;
+extern _Thread_local long first_in_phase_time;
+extern _Thread_local long end_of_execution_time;
 
-extern FILE *input_tasks_file;
-extern FILE *input_freq_file;
-extern FILE *output_file;
-extern FILE *statistics_file;
+extern Input_file input_tasks_file;
+extern Input_file input_freq_file;
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+extern _Thread_local FILE *json_file;
+
+// State of the psuedo-random number generator of the simulation running in this thread.
+_Thread_local unsigned long long random_state;
 
 
 /*
@@ -29,23 +39,90 @@ extern FILE *statistics_file;
 void
 open_files_and_init_data()
 {
-    // Opening the I/O files.
-    input_tasks_file = fopen(INPUT_TASKS_FILE_NAME, "r");
-    input_freq_file = fopen(INPUT_FREQ_FILE_NAME, "r");
+    // Opening the I/O files. The input files are memory-mapped and scanned in place.
+    open_input_file(&input_tasks_file, INPUT_TASKS_FILE_NAME);
+    open_input_file(&input_freq_file, INPUT_FREQ_FILE_NAME);
     output_file = fopen(OUTPUT_FILE_NAME, "w");
     statistics_file = fopen(OUTPUT_STATISTICS_FILE_NAME, "w");
+    json_file = fopen(OUTPUT_JSON_FILE_NAME, "w");
+    if (TRACE_EXPORT && (NUM_CORES == 1 || GLOBAL_SCHEDULING)) // Partitioned cores have traces of their own.
+        open_trace(OUTPUT_TRACE_FILE_NAME);
+    if (SCHEDULE_LOG && NUM_CORES == 1) // The global scheduler is not logged.
+        open_schedule_log(OUTPUT_SCHEDULE_LOG_FILE_NAME);
 
     // Checking for errors in file opening.
     files_not_null_check();
 
+    // The overheads are needed by the schedulability tests (and so by the cache key).
+    init_overhead_model();
+
+    // Load and print the task-set, frequencies and the metadata directly if these inputs were already preprocessed in an earlier run.
+    if (USE_TASKSET_CACHE && load_taskset_cache())
+    {
+        print_taskset_metadata();
+    }
+    else
+    {
+        convert_inputs();
+
+        if (USE_TASKSET_CACHE)
+            save_taskset_cache();
+    }
+
+    // Create, sort and print jobs.
+    create_sort_print_jobs();
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The memory-mapped input files.
+ * Post-condition: Creates, inputs, sorts and prints the task-set and the frequency and voltage inputs along with the metadata of the task-set.
+ */
+void
+convert_inputs()
+{
     // Create, input, sort and print the task-set.
     create_input_sort_print_tasks();
 
     // Input, sort and print the frequency and voltage inputs. Also finds the static frequency and voltage.
     input_sort_print_freq_and_voltage();
 
-    // Create, sort and print jobs.
-    create_sort_print_jobs();
+    return;
+}
+
+
+/*
+ * Pre-condition: The text input files.
+ * Post-condition: Converts the text inputs to a task-set cache file (without scheduling the task-set).
+ */
+void
+convert_to_taskset_cache()
+{
+    open_input_file(&input_tasks_file, INPUT_TASKS_FILE_NAME);
+    open_input_file(&input_freq_file, INPUT_FREQ_FILE_NAME);
+    output_file = fopen(OUTPUT_FILE_NAME, "w");
+    if (!output_file)
+    {
+        fprintf(stderr, "ERROR: Could not open the required files.\n");
+        exit(0);
+    }
+
+    init_overhead_model();
+    convert_inputs();
+    save_taskset_cache();
+
+    char file_name[256];
+    find_taskset_cache_file_name(file_name, sizeof(file_name));
+    printf("Task-set cache written to %s.\n", file_name);
+
+    close_input_file(&input_tasks_file);
+    close_input_file(&input_freq_file);
+    fclose(output_file);
+    delete_freq_and_voltage();
+    delete_tasks();
+    delete_overhead_model();
 
     return;
 }
@@ -61,15 +138,20 @@ close_files_and_delete_data()
     // Closing files.
     fprintf(output_file, "\n--------------------------- THE END ---------------------------\n");
     fprintf(statistics_file, "\n--------------------------- THE END ---------------------------\n");
-    fclose(input_tasks_file);
-    fclose(input_freq_file);
+    close_input_file(&input_tasks_file);
+    close_input_file(&input_freq_file);
     fclose(output_file);
     fclose(statistics_file);
+    fclose(json_file);
+    close_trace();
+    close_schedule_log();
 
     // Free task-set.
     delete_freq_and_voltage();
+    delete_task_histograms();
     delete_jobs();
     delete_tasks();
+    delete_overhead_model();
 
     return;
 }
@@ -83,7 +165,8 @@ void
 files_not_null_check()
 {
     // File pointer is null when there is an error in opening the files.
-    if (!input_tasks_file || !input_freq_file || !output_file || !statistics_file)
+    // (The input files are checked when they are mapped.)
+    if (!output_file || !statistics_file || !json_file)
     {
         fprintf(stderr, "ERROR: Could not open the required files.\n");
         exit(0);
@@ -233,11 +316,7 @@ calculate_num_instances_of_tasks()
 float
 find_task_utilisation()
 {
-    float task_utilisation = 0; // To calculate the worst-case CPU utilisation.
-    for (int i = 0; i < num_tasks; i++) // Iterating through each task in the task-set.
-    {
-        task_utilisation += (tasks[i].wcet / tasks[i].period);
-    }
+    float task_utilisation = calculate_task_utilisation(); // To calculate the worst-case CPU utilisation.
 
     if (task_utilisation > 1)
     {
@@ -252,6 +331,66 @@ find_task_utilisation()
 }
 
 
+/*
+ * Pre-condition: The periods and wcet of all tasks.
+ * Post-condition: The worst-case CPU utilisation value for the given task-set (without printing it).
+ */
+float
+calculate_task_utilisation()
+{
+    float task_utilisation = 0;
+    for (int i = 0; i < num_tasks; i++) // Iterating through each task in the task-set.
+    {
+        task_utilisation += (tasks[i].wcet / tasks[i].period);
+    }
+
+    return task_utilisation;
+}
+
+
+/*
+ * Pre-condition: A seed.
+ * Post-condition: The psuedo-random number generator of this thread starts a new sequence from the seed.
+ */
+void
+seed_random(unsigned long long seed)
+{
+    // Splitmix64 of the seed, so that close seeds (like those of different cores) give unrelated sequences. The state can never be 0.
+    unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    random_state = (z ^ (z >> 31)) | 1;
+
+    return;
+}
+
+
+/*
+ * Pre-condition: A seeded psuedo-random number generator.
+ * Post-condition: The next psuedo-random number of this thread (xorshift64*).
+ */
+unsigned long
+next_random()
+{
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+
+    return (random_state * 0x2545F4914F6CDD1DULL) >> 33;
+}
+
+
+/*
+ * Pre-condition: A seeded psuedo-random number generator.
+ * Post-condition: A psuedo-random number that is uniformly distributed in (0, 1).
+ */
+float
+random_uniform()
+{
+    return ((next_random() % 1000000) + 1) / 1000001.0;
+}
+
+
 /*
  * Pre-condition: A float value.
  * Post-condition: The absolute value of the given float number.
@@ -2,11 +2,16 @@
 void open_files_and_init_data(); // Master function related to opening files and creating, inputting, sorting and printing the data.
 void close_files_and_delete_data(); // Master function related to close files and related to deallocating heap memory.
 void files_not_null_check();
+void convert_inputs(); // Reads the text inputs and derives the metadata of the task-set.
+void convert_to_taskset_cache(); // Converts the text inputs to a task-set cache file.
 
 // General Utility functions.
 float gcd(float, float); // To find the gcd of two numbers.
 float lcm(float, float); // To find the lcm of two numbers.
 float floatAbs(float); // To find the absolute value of a floating point number.
+void seed_random(unsigned long long); // Seeds the psuedo-random number generator of the current thread.
+unsigned long next_random(); // The next psuedo-random number of the current thread.
+float random_uniform(); // A psuedo-random number in (0, 1).
 
 // Functions related to finding meta-data of the task-set before execution starts.
 void find_hyperperiod(); // Calculates the hyperperiod.
@@ -14,4 +19,5 @@ void find_first_in_phase_time(); // Calculates the first in-phase time.
 void find_end_of_execution_time(); // Calculates the end of execution time.
 
 void calculate_num_instances_of_tasks(); // Calculates the total number of jobs to schedule.
-float find_task_utilisation(); // Calculates the worst-case task utilisation of the task-set.
\ No newline at end of file
+float find_task_utilisation(); // Calculates and prints the worst-case task utilisation of the task-set.
+float calculate_task_utilisation(); // Calculates the worst-case task utilisation of the task-set.
\ No newline at end of file
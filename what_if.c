@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "configuration.h"
+#include "task.h"
+#include "job.h"
+#include "checkpoint.h"
+#include "what_if.h"
+
+// Global variables required to simulate a change of the base run incrementally.
+
+// Output files.
+extern _Thread_local FILE *output_file;
+extern _Thread_local FILE *statistics_file;
+
+// Tasks and jobs.
+extern _Thread_local int num_tasks;
+extern _Thread_local Task *tasks;
+extern _Thread_local int num_jobs;
+extern _Thread_local Job *jobs;
+extern _Thread_local long end_of_execution_time;
+
+// Scheduler.
+extern _Thread_local int core_num;
+extern _Thread_local float current_time;
+extern _Thread_local int current_job_overall_job_index;
+extern _Thread_local int checkpoints_enabled;
+extern _Thread_local int spliced_with_base_run;
+
+// How much of the schedule is simulated again.
+_Thread_local int num_what_if_jobs; // Jobs of this core whose wcet is changed.
+_Thread_local int last_what_if_job; // Index of the last changed job in the jobs array (-1 if there is none).
+_Thread_local float what_if_resume_time; // Time of the snapshot that the simulation resumed from.
+_Thread_local float what_if_converge_time; // Time at which the state was back on the base run (-1 if it never was).
+
+
+/*
+ * Pre-condition: The initialised scheduler, and the snapshots of the base run.
+ * Post-condition: The scheduler continues from the last snapshot of the base run before the first changed job (or from t=0), and the jobs in the window have the new wcet.
+ * If none of the jobs of this core is changed, the schedule of the core is that of the base run, so its final state is restored.
+ *
+ * Only the release of a changed job can make the schedule differ from the base run (a job is not looked at before it is released), so every snapshot taken before it is still valid.
+ */
+void
+init_what_if()
+{
+    num_what_if_jobs = 0;
+    last_what_if_job = -1;
+    what_if_resume_time = 0;
+    what_if_converge_time = -1;
+    long window_end = (WHAT_IF_END > WHAT_IF_START) ? WHAT_IF_END : end_of_execution_time;
+
+    // The jobs are sorted based on arrival time.
+    int first_what_if_job = -1;
+    for (int i = 0; i < num_jobs && first_what_if_job == -1; i++)
+    {
+        if (tasks[jobs[i].sorted_task_num].task_num == WHAT_IF_TASK && jobs[i].arrival_time >= WHAT_IF_START && jobs[i].arrival_time < window_end)
+            first_what_if_job = i;
+    }
+
+    char file_name[256];
+    if (first_what_if_job == -1)
+    {
+        find_checkpoint_file_name(file_name, sizeof(file_name), core_num, CHECKPOINT_FINAL);
+        if (!restore_checkpoint(file_name))
+        {
+            fprintf(stderr, "ERROR: The what-if simulation needs the final snapshot %s of the base run.\n", file_name);
+            exit(0);
+        }
+        what_if_resume_time = current_time;
+        spliced_with_base_run = 1;
+        return;
+    }
+
+    // Resuming from the last snapshot taken before the release of the first changed job.
+    long interval = CHECKPOINT_INTERVAL;
+    if (interval <= 0)
+    {
+        fprintf(stderr, "ERROR: The what-if simulation needs the snapshots of the base run (CHECKPOINT_INTERVAL > 0).\n");
+        exit(0);
+    }
+    long first_release = jobs[first_what_if_job].arrival_time;
+    for (long time = (first_release / interval) * interval; time > 0; time -= interval)
+    {
+        Checkpoint_header header;
+        find_checkpoint_file_name(file_name, sizeof(file_name), core_num, time);
+        FILE *file = open_checkpoint(file_name, &header);
+        if (!file)
+            continue;
+        fclose(file);
+
+        if (header.time < first_release)
+        {
+            restore_checkpoint(file_name);
+            what_if_resume_time = current_time;
+            break;
+        }
+    }
+
+    for (int i = first_what_if_job; i < num_jobs; i++)
+    {
+        if (tasks[jobs[i].sorted_task_num].task_num == WHAT_IF_TASK && jobs[i].arrival_time >= WHAT_IF_START && jobs[i].arrival_time < window_end)
+        {
+            jobs[i].wcet = WHAT_IF_WCET;
+            last_what_if_job = i;
+            num_what_if_jobs++;
+        }
+    }
+
+    fprintf(output_file, "What-if: %d jobs of Task-%d released from t=%ld to t=%ld have a wcet of %0.2f.\n\n", num_what_if_jobs, WHAT_IF_TASK, (long) WHAT_IF_START, window_end, (float) WHAT_IF_WCET);
+
+    return;
+}
+
+
+/*
+ * Pre-condition: The scheduler at the first decision point after the given multiple of CHECKPOINT_INTERVAL.
+ * Post-condition: If the state is the same as that of the base run at its snapshot (after all the changed jobs have been released), the rest of the base run is spliced in and 1 is returned. Otherwise returns 0.
+ */
+int
+converge_with_base_run(long checkpoint_time)
+{
+    // A changed job that is yet to be released always differs from the base run.
+    if (current_job_overall_job_index < last_what_if_job)
+        return 0;
+
+    char file_name[256], final_file_name[256];
+    find_checkpoint_file_name(file_name, sizeof(file_name), core_num, checkpoint_time);
+    if (!compare_checkpoint(file_name))
+        return 0;
+
+    what_if_converge_time = current_time;
+    find_checkpoint_file_name(final_file_name, sizeof(final_file_name), core_num, CHECKPOINT_FINAL);
+    splice_checkpoint(file_name, final_file_name);
+    spliced_with_base_run = 1;
+
+    fprintf(output_file, "\nWhat-if: The state is back on the base run (%s) at t=%0.2f. The rest of the schedule is that of the base run.\n", file_name, what_if_converge_time);
+
+    return 1;
+}
+
+
+/*
+ * Pre-condition: The scheduler after it has finished.
+ * Post-condition: Prints which part of the schedule was simulated again onto the statistics file.
+ */
+void
+print_what_if_statistics()
+{
+    if (WHAT_IF_TASK < 0 || !checkpoints_enabled)
+        return;
+
+    fprintf(statistics_file, "------------------------------------------------------------\n");
+    fprintf(statistics_file, "What-if: %d jobs of Task-%d with a wcet of %0.2f. ", num_what_if_jobs, WHAT_IF_TASK, (float) WHAT_IF_WCET);
+    if (num_what_if_jobs == 0)
+        fprintf(statistics_file, "No job of this core is changed, so its schedule is that of the base run.\n");
+    else if (what_if_converge_time >= 0)
+        fprintf(statistics_file, "Simulated again from t=%0.2f to t=%0.2f (%0.1f%% of the schedule), after which the state was back on the base run.\n", what_if_resume_time, what_if_converge_time, (what_if_converge_time - what_if_resume_time) / end_of_execution_time * 100);
+    else
+        fprintf(statistics_file, "Simulated again from t=%0.2f to the end (the state never came back to the base run).\n", what_if_resume_time);
+
+    return;
+}
@@ -0,0 +1,4 @@
+// Functions.
+void init_what_if(); // Resumes from the last snapshot of the base run before the first changed job, and changes the jobs.
+int converge_with_base_run(long); // Splices the rest of the base run if the state is back on it at one of its snapshots.
+void print_what_if_statistics(); // Prints how much of the schedule was simulated again.